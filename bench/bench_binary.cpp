@@ -0,0 +1,131 @@
+#include "json.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+using namespace wingmann;
+
+namespace {
+
+enum class format { text, msgpack, cbor };
+
+// Same shape as the load corpus: records of strings, integers, floats and small arrays.
+const json& document()
+{
+    static const json value = [] {
+        std::mt19937_64 rng{11};
+        json array = json::make(json::class_type::array);
+
+        for (int i = 0; i < 20000; ++i) {
+            json flags = json::make(json::class_type::array);
+            flags.append(true, false, nullptr);
+
+            json position = json::make(json::class_type::array);
+            position.append(static_cast<double>(rng() % 36000) / 100 - 180);
+            position.append(static_cast<double>(rng() % 18000) / 100 - 90);
+
+            json item = json::object();
+            item["id"] = i;
+            item["name"] = "user " + std::to_string(rng() % 100000);
+            item["bio"] = "line one\nline \"two\"";
+            item["score"] = static_cast<double>(rng() % 1000000) / 1000;
+            item["flags"] = std::move(flags);
+            item["position"] = std::move(position);
+            array.append(std::move(item));
+        }
+        return array;
+    }();
+    return value;
+}
+
+void encode(const json& value, format kind, std::string& buffer)
+{
+    switch (kind) {
+    case format::text:
+        value.dump(buffer, json::dump_style::compact);
+        break;
+    case format::msgpack:
+        value.dump_msgpack(buffer);
+        break;
+    case format::cbor:
+        value.dump_cbor(buffer);
+        break;
+    }
+}
+
+json decode(std::string_view data, format kind)
+{
+    switch (kind) {
+    case format::msgpack:
+        return json::load_msgpack(data);
+    case format::cbor:
+        return json::load_cbor(data);
+    default:
+        return json::load(data);
+    }
+}
+
+void run_dump_benchmark(benchmark::State& state, format kind)
+{
+    const auto& value = document();
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        encode(value, kind, buffer);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+    state.counters["size"] = static_cast<double>(buffer.size());
+}
+
+void run_load_benchmark(benchmark::State& state, format kind)
+{
+    std::string buffer;
+    encode(document(), kind, buffer);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(decode(buffer, kind));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+    state.counters["size"] = static_cast<double>(buffer.size());
+}
+
+void bm_dump_text(benchmark::State& state)
+{
+    run_dump_benchmark(state, format::text);
+}
+
+void bm_dump_msgpack(benchmark::State& state)
+{
+    run_dump_benchmark(state, format::msgpack);
+}
+
+void bm_dump_cbor(benchmark::State& state)
+{
+    run_dump_benchmark(state, format::cbor);
+}
+
+void bm_load_text(benchmark::State& state)
+{
+    run_load_benchmark(state, format::text);
+}
+
+void bm_load_msgpack(benchmark::State& state)
+{
+    run_load_benchmark(state, format::msgpack);
+}
+
+void bm_load_cbor(benchmark::State& state)
+{
+    run_load_benchmark(state, format::cbor);
+}
+
+} // namespace
+
+BENCHMARK(bm_dump_text);
+BENCHMARK(bm_dump_msgpack);
+BENCHMARK(bm_dump_cbor);
+BENCHMARK(bm_load_text);
+BENCHMARK(bm_load_msgpack);
+BENCHMARK(bm_load_cbor);
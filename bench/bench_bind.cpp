@@ -0,0 +1,142 @@
+#include "json.h"
+#include "json_bind.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace wingmann;
+
+namespace bench {
+
+struct order_line {
+    std::int64_t sku{};
+    std::int64_t quantity{};
+    double price{};
+};
+JSONLW_BIND(order_line, sku, quantity, price)
+
+struct order {
+    std::int64_t id{};
+    std::string customer;
+    bool paid{};
+    std::vector<order_line> lines;
+};
+JSONLW_BIND(order, id, customer, paid, lines)
+
+} // namespace bench
+
+namespace {
+
+const std::vector<bench::order>& orders()
+{
+    static const std::vector<bench::order> values = [] {
+        std::vector<bench::order> result(10000);
+
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            auto& o = result[i];
+            o.id = static_cast<std::int64_t>(i);
+            o.customer = "customer " + std::to_string(i % 997);
+            o.paid = (i % 3) != 0;
+            for (std::int64_t j = 0; j < 4; ++j)
+                o.lines.push_back({j * 1000 + 7, j + 1, 9.99 * static_cast<double>(j + 1)});
+        }
+        return result;
+    }();
+    return values;
+}
+
+json to_dom(const std::vector<bench::order>& values)
+{
+    json array = json::make(json::class_type::array);
+
+    for (const auto& o : values) {
+        json lines = json::make(json::class_type::array);
+        for (const auto& line : o.lines) {
+            json item = json::object();
+            item["sku"] = line.sku;
+            item["quantity"] = line.quantity;
+            item["price"] = line.price;
+            lines.append(std::move(item));
+        }
+
+        json item = json::object();
+        item["id"] = o.id;
+        item["customer"] = o.customer;
+        item["paid"] = o.paid;
+        item["lines"] = std::move(lines);
+        array.append(std::move(item));
+    }
+    return array;
+}
+
+std::vector<bench::order> from_dom(const json& array)
+{
+    std::vector<bench::order> values;
+
+    for (const auto& item : array.array_range()) {
+        auto& o = values.emplace_back();
+        o.id = item.at("id").to_int();
+        o.customer = item.at("customer").to_string();
+        o.paid = item.at("paid").to_bool();
+        for (const auto& line : item.at("lines").array_range())
+            o.lines.push_back(
+                {line.at("sku").to_int(), line.at("quantity").to_int(), line.at("price").to_float()});
+    }
+    return values;
+}
+
+void bm_bind_dump(benchmark::State& state)
+{
+    const auto& values = orders();
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        json_sink sink{buffer};
+        json_dump(sink, values);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+void bm_dom_dump(benchmark::State& state)
+{
+    const auto& values = orders();
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        to_dom(values).dump(buffer, json::dump_style::compact);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+void bm_bind_load(benchmark::State& state)
+{
+    const auto text = json_dump(orders());
+
+    for (auto _ : state) {
+        std::vector<bench::order> values;
+        json_load(text, values);
+        benchmark::DoNotOptimize(values);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+void bm_dom_load(benchmark::State& state)
+{
+    const auto text = json_dump(orders());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(from_dom(json::load(text)));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * text.size()));
+}
+
+} // namespace
+
+BENCHMARK(bm_bind_dump);
+BENCHMARK(bm_dom_dump);
+BENCHMARK(bm_bind_load);
+BENCHMARK(bm_dom_load);
@@ -0,0 +1,278 @@
+#include "bench_corpus.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+namespace bench {
+namespace {
+
+using random_engine = std::mt19937_64;
+
+std::uint64_t pick(random_engine& rng, std::uint64_t bound)
+{
+    return rng() % bound;
+}
+
+std::string number(std::uint64_t value)
+{
+    return std::to_string(value);
+}
+
+/// A floating-point number with the given digits after the point, like GeoJSON coordinates.
+std::string fixed(double value, int digits)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+    return buffer;
+}
+
+std::string quoted(std::string_view text)
+{
+    return "\"" + std::string{text} + "\"";
+}
+
+// Words mixing ASCII, raw UTF-8 and escapes, as in the text of tweets.
+constexpr std::string_view words[]{
+    "the",
+    "stream",
+    "\xe5\x90\x8d\xe5\x89\x8d",
+    "\xe3\x81\x82\xe3\x82\x86\xe3\x81\xbf",
+    "caf\xc3\xa9",
+    "\\u2764",
+    "\\n",
+    "\\\"quote\\\"",
+    "https:\\/\\/t.co\\/xyz",
+    "#jsonlw",
+    "@someone",
+    "\xf0\x9f\x98\x80"};
+
+std::string sentence(random_engine& rng, std::size_t length)
+{
+    std::string text;
+    for (std::size_t i = 0; i < length; ++i) {
+        if (i != 0)
+            text += ' ';
+        text += words[pick(rng, std::size(words))];
+    }
+    return text;
+}
+
+std::string twitter_user(random_engine& rng)
+{
+    const auto id = 100000000 + pick(rng, 900000000);
+
+    return R"({"id":)" + number(id) + R"(,"id_str":")" + number(id) + R"(","name":)" +
+           quoted(sentence(rng, 2)) + R"(,"screen_name":"user_)" + number(pick(rng, 100000)) +
+           R"(","location":)" + quoted(sentence(rng, 2)) + R"(,"description":)" +
+           quoted(sentence(rng, 12)) +
+           R"(,"url":null,"entities":{"description":{"urls":[]}},"protected":false,)" +
+           R"("followers_count":)" + number(pick(rng, 100000)) + R"(,"friends_count":)" +
+           number(pick(rng, 5000)) + R"(,"listed_count":)" + number(pick(rng, 100)) +
+           R"(,"created_at":"Sun Jul 29 05:33:46 +0000 2012","favourites_count":)" +
+           number(pick(rng, 10000)) +
+           R"(,"utc_offset":null,"time_zone":null,"geo_enabled":false,"verified":false,)" +
+           R"("statuses_count":)" + number(pick(rng, 50000)) +
+           R"(,"lang":"ja","contributors_enabled":false,"is_translator":false,)" +
+           R"("profile_background_color":"C0DEED","profile_background_image_url":)" +
+           R"("http:\/\/abs.twimg.com\/images\/themes\/theme1\/bg.png",)" +
+           R"("profile_image_url":"http:\/\/pbs.twimg.com\/profile_images\/)" +
+           number(pick(rng, 1000000)) + R"(\/normal.jpeg","profile_link_color":"0084B4",)" +
+           R"("default_profile":true,"following":false,"notifications":false})";
+}
+
+std::string tweet(random_engine& rng, bool allow_retweet)
+{
+    const auto id = 505874000000000000 + pick(rng, 1000000000);
+    std::string mentions;
+
+    for (std::uint64_t i = 0, n = pick(rng, 3); i < n; ++i) {
+        if (i != 0)
+            mentions += ',';
+        const auto user = 100000000 + pick(rng, 900000000);
+        mentions += R"({"screen_name":"user_)" + number(pick(rng, 100000)) + R"(","name":)" +
+                    quoted(sentence(rng, 2)) + R"(,"id":)" + number(user) + R"(,"id_str":")" +
+                    number(user) + R"(","indices":[0,9]})";
+    }
+
+    std::string text = R"({"metadata":{"result_type":"recent","iso_language_code":"ja"},)" +
+                       std::string{R"("created_at":"Sun Aug 31 00:29:15 +0000 2014","id":)"} +
+                       number(id) + R"(,"id_str":")" + number(id) + R"(","text":)" +
+                       quoted(sentence(rng, 20 + pick(rng, 20))) +
+                       R"(,"source":"<a href=\"http:\/\/twitter.com\/download\/iphone\" )" +
+                       R"(rel=\"nofollow\">Twitter for iPhone<\/a>","truncated":false,)" +
+                       R"("in_reply_to_status_id":null,"in_reply_to_user_id":null,"user":)" +
+                       twitter_user(rng) +
+                       R"(,"geo":null,"coordinates":null,"place":null,"contributors":null,)";
+
+    if (allow_retweet && (pick(rng, 3) == 0))
+        text += R"("retweeted_status":)" + tweet(rng, false) + ",";
+
+    text += R"("retweet_count":)" + number(pick(rng, 1000)) + R"(,"favorite_count":)" +
+            number(pick(rng, 1000)) +
+            R"(,"entities":{"hashtags":[],"symbols":[],"urls":[],"user_mentions":[)" + mentions +
+            R"(]},"favorited":false,"retweeted":false,"lang":"ja"})";
+    return text;
+}
+
+std::string twitter()
+{
+    random_engine rng{1};
+    std::string text{R"({"statuses":[)"};
+
+    for (int i = 0; i < 200; ++i) {
+        if (i != 0)
+            text += ',';
+        text += tweet(rng, true);
+    }
+    text += R"(],"search_metadata":{"completed_in":0.087,"max_id":505874924095815681,)"
+            R"("query":"%E4%B8%80","count":100,"since_id":0}})";
+    return text;
+}
+
+std::string canada()
+{
+    random_engine rng{2};
+    std::uniform_real_distribution<double> step{-0.05, 0.05};
+    std::string text{R"({"type":"FeatureCollection","features":[{"type":"Feature",)"
+                     R"("properties":{"name":"Canada"},"geometry":{"type":"Polygon",)"
+                     R"("coordinates":[)"};
+
+    for (int ring = 0; ring < 480; ++ring) {
+        if (ring != 0)
+            text += ',';
+        text += '[';
+
+        double longitude = -140 + static_cast<double>(pick(rng, 8000)) / 100;
+        double latitude = 42 + static_cast<double>(pick(rng, 3000)) / 100;
+        for (int point = 0; point < 116; ++point) {
+            if (point != 0)
+                text += ',';
+            longitude += step(rng);
+            latitude += step(rng);
+            text += '[' + fixed(longitude, 15) + ',' + fixed(latitude, 15) + ']';
+        }
+        text += ']';
+    }
+    text += "]}}]}";
+    return text;
+}
+
+std::string citm()
+{
+    random_engine rng{3};
+    auto id = [&rng] { return number(100000000 + pick(rng, 300000000)); };
+
+    std::string area_names;
+    for (int i = 0; i < 17; ++i)
+        area_names += ((i != 0) ? "," : "") + quoted(id()) + ":" + quoted(sentence(rng, 2));
+
+    std::string events;
+    for (int i = 0; i < 184; ++i) {
+        const auto event = id();
+        events += ((i != 0) ? "," : "") + quoted(event) + R"(:{"description":null,"id":)" +
+                  event + R"(,"logo":)" +
+                  ((pick(rng, 2) == 0) ? std::string{"null"}
+                                       : quoted("\\/images\\/UE0AAAAACEKo6QAAAAZDSVRN")) +
+                  R"(,"name":)" + quoted(sentence(rng, 3)) + R"(,"subTopicIds":[)" + id() + "," +
+                  id() + R"(],"subjectCode":null,"subtitle":null,"topicIds":[)" + id() + "," +
+                  id() + "]}";
+    }
+
+    std::string performances;
+    for (int i = 0; i < 243; ++i) {
+        std::string prices;
+        for (int j = 0, n = 2 + static_cast<int>(pick(rng, 4)); j < n; ++j) {
+            prices += ((j != 0) ? "," : "") + std::string{R"({"amount":)"} +
+                      number(5000 + pick(rng, 100000)) + R"(,"audienceSubCategoryId":)" + id() +
+                      R"(,"seatCategoryId":)" + id() + "}";
+        }
+
+        std::string categories;
+        for (int j = 0, n = 2 + static_cast<int>(pick(rng, 4)); j < n; ++j) {
+            std::string areas;
+            for (int k = 0, m = 4 + static_cast<int>(pick(rng, 10)); k < m; ++k)
+                areas += ((k != 0) ? "," : "") + std::string{R"({"areaId":)"} + id() +
+                         R"(,"blockIds":[]})";
+            categories += ((j != 0) ? "," : "") + std::string{R"({"areas":[)"} + areas +
+                          R"(],"seatCategoryId":)" + id() + "}";
+        }
+
+        performances += ((i != 0) ? "," : "") + std::string{R"({"eventId":)"} + id() +
+                        R"(,"id":)" + id() + R"(,"logo":null,"name":null,"prices":[)" + prices +
+                        R"(],"seatCategories":[)" + categories +
+                        R"(],"seatMapImage":null,"start":)" +
+                        number(1372701600000 + pick(rng, 100000000)) +
+                        R"(,"venueCode":"PLEYEL_PLEYEL"})";
+    }
+
+    return R"({"areaNames":{)" + area_names +
+           R"(},"audienceSubCategoryNames":{"337100890":"Abonné"},"blockNames":{},)" +
+           R"("events":{)" + events + R"(},"performances":[)" + performances +
+           R"(],"seatCategoryNames":{"338937295":"1ère catégorie"},)" +
+           R"("subTopicNames":{"337184262":"Musique amplifiée"},"subjectNames":{},)" +
+           R"("topicNames":{"107888604":"Activité"},)" +
+           R"("venueNames":{"PLEYEL_PLEYEL":"Salle Pleyel"}})";
+}
+
+std::string deep()
+{
+    constexpr int chains{64};
+    constexpr int depth{500};
+    std::string text{"["};
+
+    for (int chain = 0; chain < chains; ++chain) {
+        if (chain != 0)
+            text += ',';
+        for (int level = 0; level < depth; ++level)
+            text += (level % 2 == 0) ? R"({"level":)" + number(level) + R"(,"next":)" : "[1,";
+        text += "null";
+        for (int level = depth - 1; level >= 0; --level)
+            text += (level % 2 == 0) ? '}' : ']';
+    }
+    text += ']';
+    return text;
+}
+
+std::string wide()
+{
+    random_engine rng{5};
+    std::string text{"{"};
+
+    for (int i = 0; i < 100000; ++i) {
+        if (i != 0)
+            text += ',';
+        text += "\"member_" + number(static_cast<std::uint64_t>(i)) + "\":";
+        switch (i % 4) {
+        case 0:
+            text += number(pick(rng, 1000000));
+            break;
+        case 1:
+            text += quoted("value " + number(pick(rng, 1000)));
+            break;
+        case 2:
+            text += fixed(static_cast<double>(pick(rng, 1000000)) / 1000, 3);
+            break;
+        default:
+            text += (pick(rng, 2) == 0) ? "true" : "null";
+            break;
+        }
+    }
+    text += '}';
+    return text;
+}
+
+} // namespace
+
+const std::vector<corpus>& corpora()
+{
+    static const std::vector<corpus> documents{
+        {"twitter", twitter()},
+        {"canada", canada()},
+        {"citm", citm()},
+        {"deep", deep()},
+        {"wide", wide()}};
+    return documents;
+}
+
+} // namespace bench
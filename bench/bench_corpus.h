@@ -0,0 +1,29 @@
+#ifndef WINGMANN_JSONLW_BENCH_CORPUS_H
+#define WINGMANN_JSONLW_BENCH_CORPUS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+/// A named JSON document generated in the benchmark binary, the same on every run.
+struct corpus {
+    std::string_view name;
+    std::string text;
+};
+
+/**
+ * Documents shaped like the usual parser corpora, plus two synthetic extremes:
+ *
+ * - twitter: search results with nested users and entities, long non-ASCII strings and escapes;
+ * - canada: a GeoJSON polygon set, almost all floating-point coordinates;
+ * - citm: an event catalog of integers, short strings, nulls and objects keyed by id;
+ * - deep: chains of arrays and objects nested hundreds of levels down;
+ * - wide: one object with a hundred thousand members.
+ */
+const std::vector<corpus>& corpora();
+
+} // namespace bench
+
+#endif // WINGMANN_JSONLW_BENCH_CORPUS_H
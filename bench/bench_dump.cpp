@@ -0,0 +1,66 @@
+#include "json.h"
+#include "json_thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+using namespace wingmann;
+
+namespace {
+
+const json& report_document()
+{
+    static const json document = [] {
+        json rows = json::make(json::class_type::array);
+        rows.reserve(1000000);
+
+        for (int i = 0; i < 1000000; ++i) {
+            json row = json::object();
+            row["id"] = i;
+            row["name"] = "row " + std::to_string(i);
+            row["value"] = i * 0.25;
+            rows.append(std::move(row));
+        }
+
+        json report = json::object();
+        report["rows"] = std::move(rows);
+        return report;
+    }();
+    return document;
+}
+
+void bm_dump_sequential(benchmark::State& state)
+{
+    const auto& document = report_document();
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        document.dump(buffer, json::dump_style::compact);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+void bm_dump_parallel(benchmark::State& state)
+{
+    const auto& document = report_document();
+    json_thread_pool pool{static_cast<unsigned>(state.range(0))};
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        document.dump(buffer, pool, json::dump_style::compact);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+}
+
+} // namespace
+
+BENCHMARK(bm_dump_sequential)->UseRealTime();
+BENCHMARK(bm_dump_parallel)
+    ->RangeMultiplier(2)
+    ->Range(1, static_cast<std::int64_t>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
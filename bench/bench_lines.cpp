@@ -0,0 +1,80 @@
+#include "json.h"
+#include "json_key_pool.h"
+#include "json_thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace wingmann;
+
+namespace {
+
+const std::string& lines_corpus()
+{
+    static const std::string corpus = [] {
+        std::mt19937_64 rng{7};
+        std::string text;
+
+        for (int i = 0; i < 100000; ++i) {
+            text += R"({"id":)" + std::to_string(i) + R"(,"user":"user)" + std::to_string(rng() % 5000) +
+                    R"(","score":)" + std::to_string(static_cast<double>(rng() % 100000) / 100) +
+                    R"(,"tags":["a","b","c"],"active":)" + ((rng() % 2) ? "true" : "false") +
+                    "}\n";
+        }
+        return text;
+    }();
+    return corpus;
+}
+
+void bm_load_lines_sequential(benchmark::State& state)
+{
+    const auto& corpus = lines_corpus();
+
+    for (auto _ : state) {
+        std::string_view rest{corpus};
+
+        while (!rest.empty()) {
+            auto end = rest.find('\n');
+            benchmark::DoNotOptimize(json::load(rest.substr(0, end)));
+            rest.remove_prefix((end == std::string_view::npos) ? rest.size() : end + 1);
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void bm_load_lines(benchmark::State& state)
+{
+    const auto& corpus = lines_corpus();
+    json_thread_pool pool{static_cast<unsigned>(state.range(0))};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(json::load_lines(corpus, pool));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void bm_load_lines_interned(benchmark::State& state)
+{
+    const auto& corpus = lines_corpus();
+    json_thread_pool pool{static_cast<unsigned>(state.range(0))};
+    json_key_pool keys;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(json::load_lines(corpus, pool, keys));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+} // namespace
+
+BENCHMARK(bm_load_lines_sequential)->UseRealTime();
+BENCHMARK(bm_load_lines)
+    ->RangeMultiplier(2)
+    ->Range(1, static_cast<std::int64_t>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
+BENCHMARK(bm_load_lines_interned)
+    ->RangeMultiplier(2)
+    ->Range(1, static_cast<std::int64_t>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
@@ -0,0 +1,139 @@
+#include "json.h"
+#include "json_handler.h"
+#include "json_thread_pool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace wingmann;
+
+namespace {
+
+// Records with nested arrays, strings with escapes and a mix of number forms.
+const std::string& load_corpus()
+{
+    static const std::string corpus = [] {
+        std::mt19937_64 rng{11};
+        std::string text{"[\n"};
+
+        for (int i = 0; i < 20000; ++i) {
+            if (i != 0)
+                text += ",\n";
+            text += "  {\n    \"id\": " + std::to_string(i) + ",\n    \"name\": \"user " +
+                    std::to_string(rng() % 100000) + "\",\n    \"bio\": \"line one\\nline \\\"two\\\"\"," +
+                    "\n    \"score\": " + std::to_string(static_cast<double>(rng() % 1000000) / 1000) +
+                    ",\n    \"flags\": [true, false, null],\n    \"position\": [" +
+                    std::to_string(static_cast<double>(rng() % 36000) / 100 - 180) + ", " +
+                    std::to_string(static_cast<double>(rng() % 18000) / 100 - 90) + "]\n  }";
+        }
+        text += "\n]\n";
+        return text;
+    }();
+    return corpus;
+}
+
+/// Counts the allocations made through it.
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    std::size_t allocations{};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/// Counts the nodes that need memory: arrays, objects, and strings and keys too long to be
+/// stored inline.
+class allocated_node_counter final : public json_handler {
+public:
+    std::size_t nodes{};
+
+    bool on_string(std::string_view value) override
+    {
+        nodes += (value.size() > json::short_string_capacity) ? 1 : 0;
+        return true;
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        nodes += (key.size() > json_key::inline_capacity) ? 1 : 0;
+        return true;
+    }
+
+    bool on_start_object() override
+    {
+        ++nodes;
+        return true;
+    }
+
+    bool on_start_array() override
+    {
+        ++nodes;
+        return true;
+    }
+};
+
+void run_load_benchmark(benchmark::State& state, json::parser_backend backend)
+{
+    const auto& corpus = load_corpus();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(json::load(corpus, backend));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+
+    // Each node is allocated once: a container or long string takes its holder and one buffer
+    // of its final size, so allocations stay at twice the nodes.
+    counting_resource counter;
+    allocated_node_counter nodes;
+    benchmark::DoNotOptimize(json::load(corpus, backend, &counter));
+    json::parse(corpus, nodes);
+    state.counters["allocations"] = static_cast<double>(counter.allocations);
+    state.counters["nodes"] = static_cast<double>(nodes.nodes);
+}
+
+void bm_load_recursive_descent(benchmark::State& state)
+{
+    run_load_benchmark(state, json::parser_backend::recursive_descent);
+}
+
+void bm_load_structural_index(benchmark::State& state)
+{
+    run_load_benchmark(state, json::parser_backend::structural_index);
+}
+
+void bm_load_parallel(benchmark::State& state)
+{
+    const auto& corpus = load_corpus();
+    json_thread_pool pool{static_cast<unsigned>(state.range(0))};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(json::load(corpus, pool));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+} // namespace
+
+BENCHMARK(bm_load_recursive_descent);
+BENCHMARK(bm_load_structural_index);
+BENCHMARK(bm_load_parallel)
+    ->RangeMultiplier(2)
+    ->Range(1, static_cast<std::int64_t>(std::max(1u, std::thread::hardware_concurrency())))
+    ->UseRealTime();
@@ -0,0 +1,132 @@
+#include "bench_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of the benchmark binary to count what every
+// benchmark allocates. Each block is prefixed with a header that records its size, so the
+// bytes in use are known when it is freed.
+
+namespace {
+
+std::atomic<std::size_t> allocations{};
+std::atomic<std::size_t> live_bytes{};
+std::atomic<std::size_t> peak_bytes{};
+std::atomic<std::size_t> baseline_bytes{};
+
+constexpr std::size_t default_header{alignof(std::max_align_t)};
+
+void* allocate(std::size_t size, std::size_t alignment)
+{
+    const auto header = std::max(alignment, default_header);
+    // aligned_alloc wants a multiple of the alignment.
+    const auto total = (size + header + alignment - 1) / alignment * alignment;
+
+    void* block = (alignment > default_header) ? std::aligned_alloc(alignment, total)
+                                               : std::malloc(size + header);
+    if (block == nullptr)
+        throw std::bad_alloc{};
+
+    *static_cast<std::size_t*>(block) = size;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    const auto live = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = peak_bytes.load(std::memory_order_relaxed);
+    while ((live > peak) &&
+           !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return static_cast<char*>(block) + header;
+}
+
+void deallocate(void* p, std::size_t alignment) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    void* block = static_cast<char*>(p) - std::max(alignment, default_header);
+    live_bytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    return allocate(size, default_header);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocate(size, default_header);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p, default_header);
+}
+
+void operator delete[](void* p) noexcept
+{
+    deallocate(p, default_header);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    deallocate(p, default_header);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    deallocate(p, default_header);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+namespace bench {
+
+void reset_memory_usage()
+{
+    allocations.store(0, std::memory_order_relaxed);
+    const auto live = live_bytes.load(std::memory_order_relaxed);
+    baseline_bytes.store(live, std::memory_order_relaxed);
+    peak_bytes.store(live, std::memory_order_relaxed);
+}
+
+memory_usage current_memory_usage()
+{
+    return {allocations.load(std::memory_order_relaxed),
+            peak_bytes.load(std::memory_order_relaxed) -
+                baseline_bytes.load(std::memory_order_relaxed)};
+}
+
+} // namespace bench
@@ -0,0 +1,42 @@
+#ifndef WINGMANN_JSONLW_BENCH_MEMORY_H
+#define WINGMANN_JSONLW_BENCH_MEMORY_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+namespace bench {
+
+/// What the global operator new of the benchmark binary has seen.
+struct memory_usage {
+    std::size_t allocations;
+    /// Most bytes allocated and not yet freed at once.
+    std::size_t peak_bytes;
+};
+
+/// Starts a measurement: counts from zero and takes the bytes in use now as the baseline.
+void reset_memory_usage();
+
+/// Allocations and peak bytes above the baseline since reset_memory_usage.
+memory_usage current_memory_usage();
+
+/**
+ * Runs operation once, outside the timed loop, and reports the allocations it made and the
+ * peak memory it used as the allocations and peak_bytes counters of state.
+ */
+template<typename Operation>
+void report_memory_usage(benchmark::State& state, Operation&& operation)
+{
+    reset_memory_usage();
+    operation();
+    const auto usage = current_memory_usage();
+
+    state.counters["allocations"] = static_cast<double>(usage.allocations);
+    state.counters["peak_bytes"] = benchmark::Counter(static_cast<double>(usage.peak_bytes),
+                                                      benchmark::Counter::kDefaults,
+                                                      benchmark::Counter::kIs1024);
+}
+
+} // namespace bench
+
+#endif // WINGMANN_JSONLW_BENCH_MEMORY_H
@@ -0,0 +1,108 @@
+#include "json.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+// The string-building parse_number this library shipped before the in-place parser,
+// kept here as the baseline. It cannot parse exponents, so the corpus has none.
+json legacy_parse_number(const std::string& str, std::size_t& offset)
+{
+    std::string value;
+    std::string expression_value;
+    char c;
+    bool is_floating{};
+    std::int64_t exp{};
+
+    while (true) {
+        c = str[offset++];
+
+        if ((c == '-') || ((c >= '0') && (c <= '9'))) {
+            value += c;
+        }
+        else if (c == '.') {
+            value += c;
+            is_floating = true;
+        }
+        else {
+            break;
+        }
+    }
+    --offset;
+
+    if (is_floating)
+        return json{std::stod(value) * std::pow(10, exp)};
+    return json{static_cast<double>(std::stoll(value))};
+}
+
+const std::vector<std::string>& number_corpus()
+{
+    static const std::vector<std::string> corpus = [] {
+        std::mt19937_64 rng{42};
+        std::vector<std::string> numbers;
+
+        for (int i = 0; i < 4096; ++i) {
+            switch (i % 4) {
+            case 0:
+                numbers.push_back(std::to_string(rng() % 1000));
+                break;
+            case 1:
+                numbers.push_back(std::to_string(static_cast<std::int64_t>(rng())));
+                break;
+            case 2:
+                numbers.push_back(std::to_string(rng() % 100000) + "." +
+                                  std::to_string(rng() % 1000000));
+                break;
+            default:
+                numbers.push_back("-" + std::to_string(rng() % 1000) + "." +
+                                  std::to_string(rng() % 100000000000000));
+                break;
+            }
+            numbers.back() += ',';
+        }
+        return numbers;
+    }();
+    return corpus;
+}
+
+template<typename Parse>
+void run_number_benchmark(benchmark::State& state, Parse parse)
+{
+    const auto& corpus = number_corpus();
+    std::size_t bytes{};
+
+    for (auto _ : state) {
+        for (const auto& number : corpus) {
+            std::size_t offset{};
+            benchmark::DoNotOptimize(parse(number, offset));
+            bytes += offset;
+        }
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+void bm_parse_number_legacy(benchmark::State& state)
+{
+    run_number_benchmark(state, legacy_parse_number);
+}
+
+void bm_parse_number(benchmark::State& state)
+{
+    run_number_benchmark(state, [](const std::string& str, std::size_t& offset) {
+        offset = str.size();
+        return json::load(str);
+    });
+}
+
+} // namespace
+
+BENCHMARK(bm_parse_number_legacy);
+BENCHMARK(bm_parse_number);
@@ -0,0 +1,98 @@
+#include "json.h"
+#include "json_view.h"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace wingmann;
+
+namespace {
+
+// Records like those of the load corpus, as the reference document read at startup.
+const std::string& document_text()
+{
+    static const std::string text = [] {
+        std::mt19937_64 rng{11};
+        std::string result{"["};
+
+        for (int i = 0; i < 20000; ++i) {
+            if (i != 0)
+                result += ",";
+            result += "{\"id\":" + std::to_string(i) + ",\"name\":\"user " +
+                      std::to_string(rng() % 100000) + "\",\"score\":" +
+                      std::to_string(static_cast<double>(rng() % 1000000) / 1000) +
+                      ",\"flags\":[true,false,null]}";
+        }
+        result += "]";
+        return result;
+    }();
+    return text;
+}
+
+const std::string& snapshot_path()
+{
+    static const std::string path = [] {
+        auto file = std::filesystem::temp_directory_path() / "jsonlw_bench.snapshot";
+        std::string blob;
+        json::load(document_text()).dump_snapshot(blob);
+        std::ofstream{file, std::ios::binary}.write(blob.data(),
+                                                    static_cast<std::streamsize>(blob.size()));
+        return file.string();
+    }();
+    return path;
+}
+
+void bm_startup_load(benchmark::State& state)
+{
+    const auto& text = document_text();
+
+    for (auto _ : state) {
+        auto document = json::load(text);
+        benchmark::DoNotOptimize(document.at(12345).at("score").to_float());
+    }
+}
+
+void bm_startup_snapshot(benchmark::State& state)
+{
+    const auto& path = snapshot_path();
+
+    for (auto _ : state) {
+        auto snapshot = json_snapshot::load_file(path);
+        benchmark::DoNotOptimize(snapshot.root().at(12345).at("score").to_float());
+    }
+}
+
+void bm_traverse_json(benchmark::State& state)
+{
+    const auto document = json::load(document_text());
+
+    for (auto _ : state) {
+        double sum{};
+        for (const auto& item : document.array_range())
+            sum += item.at("score").to_float();
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+void bm_traverse_snapshot(benchmark::State& state)
+{
+    const auto snapshot = json_snapshot::load_file(snapshot_path());
+
+    for (auto _ : state) {
+        double sum{};
+        for (auto item : snapshot.root().array_range())
+            sum += item.at("score").to_float();
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+} // namespace
+
+BENCHMARK(bm_startup_load);
+BENCHMARK(bm_startup_snapshot);
+BENCHMARK(bm_traverse_json);
+BENCHMARK(bm_traverse_snapshot);
@@ -0,0 +1,169 @@
+#include "bench_corpus.h"
+#include "bench_memory.h"
+#include "json.h"
+#include "json_handler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace wingmann;
+
+// The regression suite: every operation on every corpus, registered as corpus/<name>/<op>.
+// Each reports its throughput, and the allocations and peak memory of one run.
+
+namespace {
+
+/// Collects the strings and keys of a document, unescaped, as json_escape gets them.
+class string_collector final : public json_handler {
+public:
+    std::vector<std::string> strings;
+
+    bool on_string(std::string_view value) override
+    {
+        strings.emplace_back(value);
+        return true;
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        strings.emplace_back(key);
+        return true;
+    }
+};
+
+/// Every (object, key) pair of value, for looking each member up again.
+void collect_members(json& value, std::vector<std::pair<json*, std::string>>& members)
+{
+    if (value.json_type() == json::class_type::array) {
+        for (auto& element : value.array_range())
+            collect_members(element, members);
+    }
+    else if (value.json_type() == json::class_type::object) {
+        for (auto& [key, member] : value.object_range()) {
+            members.emplace_back(&value, std::string{key.view()});
+            collect_members(member, members);
+        }
+    }
+}
+
+void bm_load(benchmark::State& state, const bench::corpus& document)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(json::load(document.text));
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * document.text.size()));
+
+    bench::report_memory_usage(state, [&] {
+        benchmark::DoNotOptimize(json::load(document.text));
+    });
+}
+
+void bm_dump(benchmark::State& state, const bench::corpus& document)
+{
+    const auto value = json::load(document.text);
+    std::string buffer;
+
+    for (auto _ : state) {
+        buffer.clear();
+        value.dump(buffer, json::dump_style::compact);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * buffer.size()));
+
+    bench::report_memory_usage(state, [&] {
+        std::string output;
+        value.dump(output, json::dump_style::compact);
+    });
+}
+
+void bm_escape(benchmark::State& state, const bench::corpus& document)
+{
+    string_collector collector;
+    json::parse(document.text, collector);
+
+    std::size_t bytes{};
+    for (const auto& text : collector.strings)
+        bytes += text.size();
+
+    std::string buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        json_sink sink{buffer};
+        for (const auto& text : collector.strings)
+            json::json_escape(sink, text);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+}
+
+void bm_lookup(benchmark::State& state, const bench::corpus& document)
+{
+    auto value = json::load(document.text);
+    std::vector<std::pair<json*, std::string>> members;
+    collect_members(value, members);
+
+    for (auto _ : state) {
+        for (auto& [object, key] : members)
+            benchmark::DoNotOptimize(&(*object)[key]);
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * members.size()));
+}
+
+void bm_copy(benchmark::State& state, const bench::corpus& document)
+{
+    const auto value = json::load(document.text);
+
+    for (auto _ : state) {
+        json copy(value);
+        benchmark::DoNotOptimize(copy);
+
+        // Only the copy is measured; bm_destroy measures freeing it.
+        state.PauseTiming();
+        copy = json{};
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * document.text.size()));
+
+    bench::report_memory_usage(state, [&] { json copy(value); });
+}
+
+void bm_destroy(benchmark::State& state, const bench::corpus& document)
+{
+    const auto value = json::load(document.text);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        json copy(value);
+        state.ResumeTiming();
+
+        copy = json{};
+    }
+    state.SetBytesProcessed(
+        static_cast<std::int64_t>(state.iterations() * document.text.size()));
+}
+
+const bool registered = [] {
+    const std::pair<const char*, void (*)(benchmark::State&, const bench::corpus&)> operations[]{
+        {"load", bm_load},
+        {"dump", bm_dump},
+        {"escape", bm_escape},
+        {"lookup", bm_lookup},
+        {"copy", bm_copy},
+        {"destroy", bm_destroy}};
+
+    for (const auto& document : bench::corpora()) {
+        for (const auto& [name, operation] : operations) {
+            const auto title = "corpus/" + std::string{document.name} + "/" + name;
+            benchmark::RegisterBenchmark(
+                title.c_str(),
+                [&document, operation = operation](benchmark::State& state) {
+                    operation(state, document);
+                });
+        }
+    }
+    return true;
+}();
+
+} // namespace
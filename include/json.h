@@ -2,21 +2,33 @@
 #define WINGMANN_JSONLW_JSON_H
 
 #include "json_const_wrapper.h"
+#include "json_error.h"
+#include "json_object.h"
+#include "json_sink.h"
 #include "json_wrapper.h"
 
-#include <deque>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
-#include <map>
+#include <iterator>
+#include <memory_resource>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace wingmann {
 
+class json_handler;
+class json_key_pool;
+class json_thread_pool;
+struct json_stats;
+
 class json {
 public:
-    using list_type = std::deque<json>;
-    using map_type = std::map<std::string, json>;
+    using list_type = std::pmr::vector<json>;
+    using map_type = json_object<json>;
     using string_type = std::string;
+    using pmr_string_type = std::pmr::string;
     using float_type = double;
     using int_type = std::int64_t;
     using bool_type = bool;
@@ -27,24 +39,25 @@ public:
     using json_map_wraper_type = json_wrapper<json::map_type>;
     using json_const_map_wraper_type = json_const_wrapper<json::map_type>;
 
-private:
-    union backing_data {
-        list_type* json_list;
-        map_type* json_map;
-        string_type* json_string;
-        float_type json_float;
-        int_type json_int;
-        bool_type json_bool;
+    /// Strings up to this length are stored inside the json itself, without allocating.
+    static constexpr size_type short_string_capacity{14};
 
-        backing_data() = default;
-        explicit backing_data(float_type value);
-        explicit backing_data(int_type value);
-        explicit backing_data(bool_type value);
-        explicit backing_data(string_type value);
-    } internal_{};
+    /**
+     * Deepest nesting of arrays and objects that the parsers accept; CBOR tags count as a level
+     * too. Bounds the recursion, and so the stack, that a hostile input can cause.
+     */
+    static constexpr size_type max_depth{1024};
+
+    /// Smallest input, in bytes, that the parallel load splits across threads.
+    static constexpr size_type parallel_load_threshold{1024 * 1024};
+
+    /// Smallest array or object that the parallel dump splits across threads.
+    static constexpr size_type parallel_dump_threshold{4096};
+    /// Fewest elements serialized per chunk by the parallel dump.
+    static constexpr size_type parallel_dump_chunk{1024};
 
 public:
-    enum class class_type {
+    enum class class_type : std::uint8_t {
         null,
         object,
         array,
@@ -54,8 +67,61 @@ public:
         boolean
     };
 
+    enum class dump_style {
+        compact,
+        pretty
+    };
+
+    /// Parsers available to load. Both accept the same input and build the same json.
+    enum class parser_backend {
+        /// Reads the input once, character by character.
+        recursive_descent,
+        /**
+         * Finds every token with SIMD first (AVX2 when the CPU has it), then builds the json by
+         * following that index. Faster on large inputs, at the cost of four bytes of index per
+         * token while parsing.
+         */
+        structural_index
+    };
+
 private:
-    class_type type_{class_type::null};
+    static constexpr unsigned char heap_string{0xFF};
+
+    /// A node other than a short string: its type, then its value.
+    struct value_layout {
+        class_type type;
+        /// heap_string for an allocated string, otherwise unused.
+        unsigned char short_size;
+        union {
+            list_type* json_list;
+            map_type* json_map;
+            pmr_string_type* json_string;
+            float_type json_float;
+            int_type json_int;
+            bool_type json_bool;
+        };
+    };
+
+    /// A string of up to short_string_capacity characters, stored in the node itself.
+    struct short_string_layout {
+        class_type type;
+        unsigned char short_size;
+        char data[short_string_capacity];
+    };
+
+    /**
+     * The node, in one of two layouts. Both start with the type and short_size, so either may
+     * read those; a short string keeps its characters where the other types keep their value.
+     */
+    union backing_data {
+        value_layout value{};
+        short_string_layout short_string;
+
+        backing_data() = default;
+        explicit backing_data(float_type number);
+        explicit backing_data(int_type number);
+        explicit backing_data(bool_type flag);
+    } internal_{};
 
 public:
     json() = default;
@@ -66,7 +132,7 @@ public:
 
     template<typename T>
     explicit json(T value, typename std::enable_if<std::is_same<T, bool>::value>::type* = nullptr)
-        : internal_{value}, type_{class_type::boolean}
+        : internal_{value}
     {
     }
 
@@ -74,14 +140,14 @@ public:
     explicit json(T value,
                   typename std::enable_if<std::is_integral<T>::value &&
                                           !std::is_same<T, bool>::value>::type* = nullptr)
-        : internal_{static_cast<std::int64_t>(value)}, type_{class_type::integral}
+        : internal_{static_cast<std::int64_t>(value)}
     {
     }
 
     template<typename T>
     explicit json(T value,
                   typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr)
-        : internal_{static_cast<double>(value)}, type_{class_type::floating}
+        : internal_{static_cast<double>(value)}
     {
     }
 
@@ -89,11 +155,14 @@ public:
     explicit json(
         T value,
         typename std::enable_if<std::is_convertible<T, std::string>::value>::type* = nullptr)
-        : internal_{std::string{value}}, type_{class_type::string}
     {
+        if constexpr (std::is_convertible<T, std::string_view>::value)
+            assign_string(std::string_view{value});
+        else
+            assign_string(std::string{value});
     }
 
-    virtual ~json();
+    ~json();
 
     // Operators.
     json& operator=(json&& other) noexcept;
@@ -103,7 +172,7 @@ public:
     typename std::enable_if<std::is_same<T, bool>::value, json&>::type operator=(T b)
     {
         set_type(class_type::boolean);
-        internal_.json_bool = b;
+        internal_.value.json_bool = b;
         return *this;
     }
 
@@ -113,7 +182,7 @@ public:
     operator=(T i)
     {
         set_type(class_type::integral);
-        internal_.json_int = i;
+        internal_.value.json_int = i;
         return *this;
     }
 
@@ -121,30 +190,219 @@ public:
     typename std::enable_if<std::is_floating_point<T>::value, json&>::type operator=(T f)
     {
         set_type(class_type::floating);
-        internal_.json_float = f;
+        internal_.value.json_float = f;
         return *this;
     }
 
     template<typename T>
     typename std::enable_if<std::is_convertible<T, std::string>::value, json&>::type operator=(T s)
     {
-        set_type(class_type::string);
-        *internal_.json_string = std::string{s};
+        if constexpr (std::is_convertible<T, std::string_view>::value)
+            assign_string(std::string_view{s});
+        else
+            assign_string(std::string{s});
         return *this;
     }
 
-    json& operator[](const std::string& key);
+    json& operator[](std::string_view key);
     json& operator[](unsigned index);
 
     // Methods.
-    static json make(class_type type);
-    json load(const std::string& value);
+    static json make(class_type type,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses value into a new json whose strings, arrays and objects are allocated from
+     * resource. Values created later through assignment or copying use the default resource.
+     *
+     * The input is read in place and never past its end, so a network buffer or a mapped
+     * file can be parsed without copying it or terminating it.
+     *
+     * Parsing stops at the first error and a null json is returned. The overloads taking a
+     * json_error say what went wrong and where; the others only return null. Only whitespace
+     * may follow the value; anything else is json_errc::trailing_characters.
+     */
+    static json load(std::string_view value,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(const char* data,
+                     size_type size,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     json_error& error,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     parser_backend backend,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     parser_backend backend,
+                     json_error& error,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses value like load and describes the call in stats: bytes read, nodes by type, depth,
+     * allocations and time spent on strings, numbers and containers. See json_stats.
+     */
+    static json load(std::string_view value,
+                     json_error& error,
+                     json_stats& stats,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     parser_backend backend,
+                     json_error& error,
+                     json_stats& stats,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Decodes one MessagePack or CBOR item, read in place from data. Binary strings are read as
+     * strings, CBOR tags are skipped and CBOR undefined reads as null; MessagePack extension
+     * types and other CBOR simple values are rejected. Integers beyond the int64 range become
+     * floating-point numbers.
+     *
+     * Errors are reported as by load, with offsets in bytes and no line or column. Bytes left
+     * after the item are json_errc::trailing_characters.
+     */
+    static json load_msgpack(
+        std::string_view data,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_msgpack(
+        std::string_view data,
+        json_error& error,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_cbor(std::string_view data,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_cbor(std::string_view data,
+                          json_error& error,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses value like load, interning its object keys in keys, which documents with a
+     * recurring schema can share. The result refers to the keys, so keys must outlive it.
+     */
+    static json load(std::string_view value,
+                     json_key_pool& keys,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     json_key_pool& keys,
+                     json_error& error,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses the file at path straight from a read-only memory mapping of it.
+     * Inputs that cannot be mapped, such as pipes, are read into a buffer first.
+     * A file that cannot be read is reported as json_errc::io_error.
+     */
+    static json load_file(const std::string& path,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_file(const std::string& path,
+                          json_error& error,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_file(const std::string& path,
+                          parser_backend backend,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_file(const std::string& path,
+                          parser_backend backend,
+                          json_error& error,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses value like load. When it is a top-level array of at least parallel_load_threshold
+     * bytes, the elements are located first, then parsed on pool and assembled in order.
+     * Anything else is parsed on the calling thread. Errors are reported as by load, at their
+     * position in value, and a null json is returned, even when the elements before the one that
+     * failed were parsed.
+     *
+     * @warning Elements are parsed concurrently from resource, so it must be thread-safe, like
+     * the default resource or std::pmr::synchronized_pool_resource.
+     */
+    static json load(std::string_view value,
+                     json_thread_pool& pool,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load(std::string_view value,
+                     json_thread_pool& pool,
+                     json_error& error,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Parses value like the load above and describes the call in stats, including what the
+     * workers of pool did. Their durations are added up, so they may exceed total_time.
+     */
+    static json load(std::string_view value,
+                     json_thread_pool& pool,
+                     json_error& error,
+                     json_stats& stats,
+                     std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    static json load_file(const std::string& path,
+                          json_thread_pool& pool,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static json load_file(const std::string& path,
+                          json_thread_pool& pool,
+                          json_error& error,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /// One record of newline-delimited JSON.
+    struct line_result;
+
+    /**
+     * Parses newline-delimited JSON (JSON Lines), one value per line, with the lines spread
+     * over the workers of pool. Blank lines are skipped. A line that fails to parse is
+     * reported in its result and does not stop the others.
+     *
+     * @warning Lines are parsed concurrently from resource, so it must be thread-safe, like the
+     * default resource or std::pmr::synchronized_pool_resource.
+     */
+    static std::vector<line_result> load_lines(
+        std::string_view value,
+        json_thread_pool& pool,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Like load_lines, but hands each result to callback in input order as soon as its batch of
+     * lines is parsed, so memory use is bounded by two batches instead of the whole input: the
+     * workers parse the next batch while callback runs on the calling thread.
+     */
+    static void load_lines(std::string_view value,
+                           json_thread_pool& pool,
+                           const std::function<void(line_result&)>& callback,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /// Like load_lines, with the object keys of every record interned in keys.
+    static std::vector<line_result> load_lines(
+        std::string_view value,
+        json_thread_pool& pool,
+        json_key_pool& keys,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static void load_lines(std::string_view value,
+                           json_thread_pool& pool,
+                           json_key_pool& keys,
+                           const std::function<void(line_result&)>& callback,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    static std::vector<line_result> load_lines_file(
+        const std::string& path,
+        json_thread_pool& pool,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    /// Sets error to json_errc::io_error when the file cannot be read; line errors stay per line.
+    static std::vector<line_result> load_lines_file(
+        const std::string& path,
+        json_thread_pool& pool,
+        json_error& error,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Leaves the json null without destroying what it holds.
+     *
+     * @warning Only valid when everything the value holds was allocated from a resource that
+     * frees in bulk, such as std::pmr::monotonic_buffer_resource. The whole document is then
+     * reclaimed by releasing the resource, instead of one deallocation per node.
+     */
+    void release() noexcept;
 
     template<typename T>
     void append(T arg)
     {
         set_type(class_type::array);
-        internal_.json_list->emplace_back(arg);
+        internal_.value.json_list->emplace_back(arg);
     }
 
     template<typename T, typename... U>
@@ -154,15 +412,18 @@ public:
         append(args...);
     }
 
-    [[nodiscard]] const json& at(const std::string& key) const;
-    json& at(const std::string& key);
+    /// Turns the json into an array, if it is not one yet, with room for capacity elements.
+    void reserve(size_type capacity);
+
+    [[nodiscard]] const json& at(std::string_view key) const;
+    json& at(std::string_view key);
 
     [[nodiscard]] const json& at(unsigned index) const;
     json& at(unsigned index);
 
     [[nodiscard]] size_type length() const;
 
-    [[nodiscard]] bool has_key(const std::string& key) const;
+    [[nodiscard]] bool has_key(std::string_view key) const;
 
     [[nodiscard]] size_type size() const;
 
@@ -183,17 +444,72 @@ public:
     [[nodiscard]] bool to_bool() const;
     bool to_bool(bool& ok) const;
 
-    [[nodiscard]] auto array_range() const;
-    auto array_range();
+    [[nodiscard]] json_const_list_wraper_type array_range() const;
+    json_list_wraper_type array_range();
 
-    auto object_range();
-    [[nodiscard]] auto object_range() const;
+    json_map_wraper_type object_range();
+    [[nodiscard]] json_const_map_wraper_type object_range() const;
 
     [[nodiscard]] std::string dump(int depth = 1, const std::string& tab = "    ") const;
 
+    /// Serializes into the sink; pretty output starts at indentation level one.
+    void dump(json_sink& sink,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+
+    /// Appends the serialized value to buffer, which can be reused across calls.
+    void dump(std::string& buffer,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+
+    /// Appends the serialized value to buffer like dump and describes the call in stats.
+    void dump(std::string& buffer,
+              json_stats& stats,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+
+    /**
+     * Serializes like dump, with arrays and objects of at least parallel_dump_threshold
+     * elements split into chunks that are serialized on pool and written out in order.
+     * The output is identical to the sequential dump.
+     */
+    void dump(json_sink& sink,
+              json_thread_pool& pool,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+    void dump(std::string& buffer,
+              json_thread_pool& pool,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+
+    /// Serializes on pool like the dump above and describes the call in stats, like load does.
+    void dump(std::string& buffer,
+              json_thread_pool& pool,
+              json_stats& stats,
+              dump_style style = dump_style::pretty,
+              std::string_view tab = "    ") const;
+
+    /**
+     * Encodes the value as MessagePack or CBOR into sink, or appended to buffer. Integers,
+     * strings and containers get their shortest header, and floats are stored in single
+     * precision when that is exact.
+     */
+    void dump_msgpack(json_sink& sink) const;
+    void dump_msgpack(std::string& buffer) const;
+    void dump_cbor(json_sink& sink) const;
+    void dump_cbor(std::string& buffer) const;
+
+    /**
+     * Appends the value to buffer as a snapshot: one block of fixed-size slots, offsets and
+     * text that json_snapshot reads in place, without parsing it. Snapshots are meant to be
+     * written once and mapped at every start.
+     */
+    void dump_snapshot(std::string& buffer) const;
+
     friend std::ostream& operator<<(std::ostream& os, const json& value)
     {
-        os << value.dump();
+        json_sink sink{os};
+        value.dump(sink);
         return os;
     }
 
@@ -208,10 +524,87 @@ public:
     static json array();
     static json object();
 
-    static std::string json_escape(const std::string& value);
+    /**
+     * Builds an array from [first, last) in one pass, converting each element like append.
+     * Strings too long to be stored inline are allocated from resource, like the array.
+     */
+    template<typename Iterator>
+    static json array_from(Iterator first,
+                           Iterator last,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        using category = typename std::iterator_traits<Iterator>::iterator_category;
+        using element = typename std::iterator_traits<Iterator>::value_type;
+
+        json arr = json::make(json::class_type::array, resource);
+        auto& list = *arr.internal_.value.json_list;
+
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value)
+            list.reserve(static_cast<size_type>(std::distance(first, last)));
+
+        for (; first != last; ++first) {
+            if constexpr (std::is_convertible<element, std::string_view>::value)
+                list.emplace_back().assign_string(std::string_view{*first}, resource);
+            else if constexpr (std::is_convertible<element, std::string>::value)
+                list.emplace_back().assign_string(std::string{*first}, resource);
+            else
+                list.emplace_back(*first);
+        }
+        return arr;
+    }
+
+    template<typename Range>
+    static json array_from(const Range& range,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        return array_from(std::begin(range), std::end(range), resource);
+    }
+
+    static std::string json_escape(std::string_view value);
+    static void json_escape(json_sink& sink, std::string_view value);
+
+    /**
+     * Reads value and reports it to handler as a sequence of events, without building a json.
+     * Returns false on a syntax error or when a callback asks to stop, which error then
+     * describes as json_errc::cancelled.
+     */
+    static bool parse(std::string_view value, json_handler& handler);
+    static bool parse(std::string_view value, json_handler& handler, json_error& error);
 
 private:
-    void set_type(class_type type);
+    friend class json_builder;
+
+    void serialize(json_sink& sink,
+                   dump_style style,
+                   std::string_view tab,
+                   int depth,
+                   json_thread_pool* pool = nullptr) const;
+    void serialize_elements(json_sink& sink,
+                            dump_style style,
+                            std::string_view tab,
+                            int depth,
+                            json_thread_pool* pool) const;
+    void serialize_range(json_sink& sink,
+                         dump_style style,
+                         std::string_view tab,
+                         int depth,
+                         json_thread_pool* pool,
+                         size_type first,
+                         size_type last) const;
+
+    /// Fills the slot at offset at of the snapshot that starts at offset start of buffer.
+    void serialize_snapshot(std::string& buffer, size_type start, size_type at) const;
+
+    void set_type(class_type type,
+                  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    void copy_internal(const json& other);
+
+    /// Stores value inline when it fits, or in a string allocated from resource otherwise.
+    void assign_string(std::string_view value,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    void assign_string(pmr_string_type&& value);
+    [[nodiscard]] std::string_view string_view() const;
+    [[nodiscard]] bool is_short_string() const;
 
     /**
      * @warning Only call if you know that Internal is allocated.
@@ -221,18 +614,21 @@ private:
      */
     void clear_internal();
 
-public:
-    void consume_ws(const std::string& str, std::size_t& offset);
-
-    json parse_next(const std::string& str, std::size_t& offset);
-    json parse_object(const std::string& str, std::size_t& offset);
-    json parse_array(const std::string& str, std::size_t& offset);
-    json parse_string(const std::string& str, std::size_t& offset);
-    static json parse_number(const std::string& str, std::size_t& offset);
-    static json parse_bool(const std::string& str, std::size_t& offset);
-    static json parse_null(const std::string& str, std::size_t& offset);
 };
 
+struct json::line_result {
+    /// Line number in the input, counting from one.
+    size_type line;
+    json value;
+    /// False when the line is not a single valid value; value is then null.
+    bool ok;
+    /// Why the line failed, with offset, line and column relative to the line itself.
+    json_error error;
+};
+
+// Nodes are copied and scanned in bulk inside arrays and objects, so keep them at two words.
+static_assert(sizeof(json) == 16, "json node layout grew");
+
 } // namespace wingmann
 
 #endif // WINGMANN_JSONLW_JSON_H
@@ -0,0 +1,472 @@
+#ifndef WINGMANN_JSONLW_JSON_BIND_H
+#define WINGMANN_JSONLW_JSON_BIND_H
+
+#include "json.h"
+#include "json_error.h"
+#include "json_sink.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wingmann {
+
+/// Names a type in overloads found by argument-dependent lookup, such as those of JSONLW_BIND.
+template<typename T>
+struct json_tag {
+};
+
+namespace detail {
+
+struct bind_target;
+
+/**
+ * What each parser event does to a bound value, which is passed as void*.
+ * One table exists per type, built at compile time by its json_binding; the entries of events
+ * the type cannot take return false, which stops the parse.
+ */
+struct bind_ops {
+    bool (*on_null)(void* value);
+    bool (*on_bool)(void* value, bool b);
+    bool (*on_integer)(void* value, std::int64_t n);
+    /// An integer above the range of std::int64_t.
+    bool (*on_unsigned)(void* value, std::uint64_t n);
+    bool (*on_double)(void* value, double d);
+    bool (*on_string)(void* value, std::string_view s);
+    bool (*on_start_object)(void* value);
+    /// Points member at the field named key, or at a target that skips the value.
+    bool (*on_key)(void* value, std::string_view key, bind_target& member);
+    bool (*on_start_array)(void* value);
+    /// Appends an element and points element at it.
+    bool (*on_element)(void* value, bind_target& element);
+};
+
+struct bind_target {
+    void* value;
+    const bind_ops* ops;
+};
+
+/// Accepts and drops any value, for members that a bound struct has no field for.
+extern const bind_ops skip_ops;
+
+/// Table whose entries all refuse, which bindings start from.
+constexpr bind_ops reject_ops{
+    [](void*) { return false; },
+    [](void*, bool) { return false; },
+    [](void*, std::int64_t) { return false; },
+    [](void*, std::uint64_t) { return false; },
+    [](void*, double) { return false; },
+    [](void*, std::string_view) { return false; },
+    [](void*) { return false; },
+    [](void*, std::string_view, bind_target&) { return false; },
+    [](void*) { return false; },
+    [](void*, bind_target&) { return false; }};
+
+void dump_integer(json_sink& sink, std::int64_t value);
+void dump_unsigned(json_sink& sink, std::uint64_t value);
+void dump_double(json_sink& sink, double value);
+
+/// Parses text into root, reporting a value that does not fit its type as type_mismatch.
+bool parse_bound(std::string_view text, bind_target root, json_error& error);
+
+template<typename Class, typename T>
+struct bound_field {
+    std::string_view name;
+    T Class::*member;
+};
+
+template<typename Class, typename T>
+constexpr bound_field<Class, T> make_field(std::string_view name, T Class::*member)
+{
+    return {name, member};
+}
+
+} // namespace detail
+
+/**
+ * How a C++ type is written as JSON and read back: a static dump(json_sink&, const T&) and a
+ * static constexpr detail::bind_ops ops for the parser.
+ *
+ * Provided for bool, arithmetic types, std::string, std::vector, std::optional and structs
+ * declared with JSONLW_BIND; specialize it to support other types.
+ */
+template<typename T, typename = void>
+struct json_binding;
+
+template<typename T>
+detail::bind_target bind_target_of(T& value)
+{
+    return {&value, &json_binding<T>::ops};
+}
+
+template<>
+struct json_binding<bool> {
+    static void dump(json_sink& sink, bool value)
+    {
+        sink.write(value ? "true" : "false");
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_bool = [](void* value, bool b) {
+            *static_cast<bool*>(value) = b;
+            return true;
+        };
+        return ops;
+    }();
+};
+
+template<typename T>
+struct json_binding<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static void dump(json_sink& sink, T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+            detail::dump_integer(sink, value);
+        else
+            detail::dump_unsigned(sink, value);
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_integer = [](void* value, std::int64_t n) {
+            // Numbers that do not fit T are refused rather than truncated.
+            if constexpr (std::is_signed_v<T>) {
+                if ((n < std::numeric_limits<T>::min()) || (n > std::numeric_limits<T>::max()))
+                    return false;
+            }
+            else {
+                if ((n < 0) || (static_cast<std::uint64_t>(n) > std::numeric_limits<T>::max()))
+                    return false;
+            }
+            *static_cast<T*>(value) = static_cast<T>(n);
+            return true;
+        };
+        if constexpr (std::is_unsigned_v<T>) {
+            ops.on_unsigned = [](void* value, std::uint64_t n) {
+                if (n > std::numeric_limits<T>::max())
+                    return false;
+                *static_cast<T*>(value) = static_cast<T>(n);
+                return true;
+            };
+        }
+        return ops;
+    }();
+};
+
+template<typename T>
+struct json_binding<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static void dump(json_sink& sink, T value)
+    {
+        detail::dump_double(sink, static_cast<double>(value));
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_integer = [](void* value, std::int64_t n) {
+            *static_cast<T*>(value) = static_cast<T>(n);
+            return true;
+        };
+        ops.on_unsigned = [](void* value, std::uint64_t n) {
+            *static_cast<T*>(value) = static_cast<T>(n);
+            return true;
+        };
+        ops.on_double = [](void* value, double d) {
+            *static_cast<T*>(value) = static_cast<T>(d);
+            return true;
+        };
+        return ops;
+    }();
+};
+
+template<>
+struct json_binding<std::string> {
+    static void dump(json_sink& sink, const std::string& value)
+    {
+        sink.put('\"');
+        json::json_escape(sink, value);
+        sink.put('\"');
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_string = [](void* value, std::string_view s) {
+            static_cast<std::string*>(value)->assign(s.data(), s.size());
+            return true;
+        };
+        return ops;
+    }();
+};
+
+template<typename T>
+struct json_binding<std::vector<T>> {
+    static void dump(json_sink& sink, const std::vector<T>& value)
+    {
+        sink.put('[');
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            if (i != 0)
+                sink.put(',');
+            json_binding<T>::dump(sink, value[i]);
+        }
+        sink.put(']');
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_start_array = [](void* value) {
+            static_cast<std::vector<T>*>(value)->clear();
+            return true;
+        };
+        // The element stays valid until the next one is appended, by which time it is complete.
+        ops.on_element = [](void* value, detail::bind_target& element) {
+            element = bind_target_of(static_cast<std::vector<T>*>(value)->emplace_back());
+            return true;
+        };
+        return ops;
+    }();
+};
+
+/// The bits of std::vector<bool> cannot be bound one by one, so each is appended once read.
+template<>
+struct json_binding<std::vector<bool>> {
+private:
+    static constexpr detail::bind_ops element_ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_bool = [](void* value, bool b) {
+            static_cast<std::vector<bool>*>(value)->push_back(b);
+            return true;
+        };
+        return ops;
+    }();
+
+public:
+    static void dump(json_sink& sink, const std::vector<bool>& value)
+    {
+        sink.put('[');
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            if (i != 0)
+                sink.put(',');
+            json_binding<bool>::dump(sink, value[i]);
+        }
+        sink.put(']');
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_start_array = [](void* value) {
+            static_cast<std::vector<bool>*>(value)->clear();
+            return true;
+        };
+        ops.on_element = [](void* value, detail::bind_target& element) {
+            element = {value, &element_ops};
+            return true;
+        };
+        return ops;
+    }();
+};
+
+/// Null reads as and writes an empty optional; any other value goes to the contained T.
+template<typename T>
+struct json_binding<std::optional<T>> {
+private:
+    static T& contained(void* value)
+    {
+        auto& optional = *static_cast<std::optional<T>*>(value);
+        return optional ? *optional : optional.emplace();
+    }
+
+public:
+    static void dump(json_sink& sink, const std::optional<T>& value)
+    {
+        if (value)
+            json_binding<T>::dump(sink, *value);
+        else
+            sink.write("null");
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_null = [](void* value) {
+            static_cast<std::optional<T>*>(value)->reset();
+            return true;
+        };
+        ops.on_bool = [](void* value, bool b) {
+            return json_binding<T>::ops.on_bool(&contained(value), b);
+        };
+        ops.on_integer = [](void* value, std::int64_t n) {
+            return json_binding<T>::ops.on_integer(&contained(value), n);
+        };
+        ops.on_unsigned = [](void* value, std::uint64_t n) {
+            return json_binding<T>::ops.on_unsigned(&contained(value), n);
+        };
+        ops.on_double = [](void* value, double d) {
+            return json_binding<T>::ops.on_double(&contained(value), d);
+        };
+        ops.on_string = [](void* value, std::string_view s) {
+            return json_binding<T>::ops.on_string(&contained(value), s);
+        };
+        ops.on_start_object = [](void* value) {
+            return json_binding<T>::ops.on_start_object(&contained(value));
+        };
+        ops.on_key = [](void* value, std::string_view key, detail::bind_target& member) {
+            return json_binding<T>::ops.on_key(&contained(value), key, member);
+        };
+        ops.on_start_array = [](void* value) {
+            return json_binding<T>::ops.on_start_array(&contained(value));
+        };
+        ops.on_element = [](void* value, detail::bind_target& element) {
+            return json_binding<T>::ops.on_element(&contained(value), element);
+        };
+        return ops;
+    }();
+};
+
+/**
+ * Structs declared with JSONLW_BIND, written and read as objects with one member per field.
+ * Fields are looked up in the list fixed at compile time; members without a field are skipped
+ * and fields without a member keep their value.
+ */
+template<typename T>
+struct json_binding<T, std::void_t<decltype(json_fields(json_tag<T>{}))>> {
+    static void dump(json_sink& sink, const T& value)
+    {
+        sink.put('{');
+        std::apply(
+            [&](const auto&... fields) {
+                bool first{true};
+                (dump_field(sink, value, fields, first), ...);
+            },
+            json_fields(json_tag<T>{}));
+        sink.put('}');
+    }
+
+    static constexpr detail::bind_ops ops = [] {
+        auto ops = detail::reject_ops;
+        ops.on_start_object = [](void*) { return true; };
+        ops.on_key = [](void* value, std::string_view key, detail::bind_target& member) {
+            auto& object = *static_cast<T*>(value);
+
+            member = {nullptr, &detail::skip_ops};
+            std::apply(
+                [&](const auto&... fields) {
+                    ((key == fields.name ? (member = bind_target_of(object.*fields.member), true)
+                                         : false) ||
+                     ...);
+                },
+                json_fields(json_tag<T>{}));
+            return true;
+        };
+        return ops;
+    }();
+
+private:
+    template<typename Field>
+    static void dump_field(json_sink& sink, const T& value, const Field& field, bool& first)
+    {
+        if (!first)
+            sink.put(',');
+        first = false;
+
+        // Field names are C++ identifiers, so they never need escaping.
+        sink.put('\"');
+        sink.write(field.name);
+        sink.write("\":");
+        json_binding<std::decay_t<decltype(value.*field.member)>>::dump(sink, value.*field.member);
+    }
+};
+
+/// Writes value as compact JSON, straight from its fields.
+template<typename T>
+void json_dump(json_sink& sink, const T& value)
+{
+    json_binding<T>::dump(sink, value);
+}
+
+template<typename T>
+std::string json_dump(const T& value)
+{
+    std::string text;
+    json_sink sink{text};
+    json_dump(sink, value);
+    return text;
+}
+
+/**
+ * Reads text into value without building a json. Parsing stops at the first error, leaving
+ * value partly assigned; a value of the wrong type is reported as json_errc::type_mismatch,
+ * positioned just after that value.
+ */
+template<typename T>
+bool json_load(std::string_view text, T& value, json_error& error)
+{
+    return detail::parse_bound(text, bind_target_of(value), error);
+}
+
+template<typename T>
+bool json_load(std::string_view text, T& value)
+{
+    json_error error;
+    return json_load(text, value, error);
+}
+
+} // namespace wingmann
+
+// JSONLW_BIND(type, fields...) lists the fields of type, up to 16, for json_dump and json_load.
+// Use it in the namespace of type.
+
+#define JSONLW_BIND_EXPAND(x) x
+#define JSONLW_BIND_CONCAT_(a, b) a##b
+#define JSONLW_BIND_CONCAT(a, b) JSONLW_BIND_CONCAT_(a, b)
+#define JSONLW_BIND_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, \
+                           n, ...)                                                                \
+    n
+#define JSONLW_BIND_COUNT(...)                                                                    \
+    JSONLW_BIND_EXPAND(                                                                           \
+        JSONLW_BIND_COUNT_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1))
+
+#define JSONLW_BIND_FIELD(type, field) ::wingmann::detail::make_field(#field, &type::field)
+#define JSONLW_BIND_FIELDS_1(t, f) JSONLW_BIND_FIELD(t, f)
+#define JSONLW_BIND_FIELDS_2(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_1(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_3(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_2(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_4(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_3(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_5(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_4(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_6(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_5(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_7(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_6(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_8(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_7(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_9(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_8(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_10(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_9(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_11(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_10(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_12(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_11(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_13(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_12(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_14(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_13(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_15(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_14(t, __VA_ARGS__))
+#define JSONLW_BIND_FIELDS_16(t, f, ...) \
+    JSONLW_BIND_FIELD(t, f), JSONLW_BIND_EXPAND(JSONLW_BIND_FIELDS_15(t, __VA_ARGS__))
+
+#define JSONLW_BIND(type, ...)                                                                    \
+    [[maybe_unused]] constexpr auto json_fields(::wingmann::json_tag<type>)                      \
+    {                                                                                             \
+        return std::make_tuple(JSONLW_BIND_EXPAND(JSONLW_BIND_CONCAT(                             \
+            JSONLW_BIND_FIELDS_, JSONLW_BIND_COUNT(__VA_ARGS__))(type, __VA_ARGS__)));            \
+    }
+
+#endif // WINGMANN_JSONLW_JSON_BIND_H
@@ -0,0 +1,83 @@
+#ifndef WINGMANN_JSONLW_JSON_BUILDER_H
+#define WINGMANN_JSONLW_JSON_BUILDER_H
+
+#include "json.h"
+#include "json_handler.h"
+#include "json_key_pool.h"
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace wingmann {
+
+/**
+ * Handler that assembles the events it receives into a json, which is how json::load builds
+ * its result. Nodes are allocated from the resource given at construction.
+ *
+ * The elements and members of a container are collected on a stack and moved into it when it
+ * ends, so every array and object is allocated once, at its final size, and every key is
+ * stored once, as read. Given a json_key_pool, object keys are interned in it instead of being
+ * copied into every object.
+ */
+class json_builder final : public json_handler {
+private:
+    using size_type = json::size_type;
+
+    /// Bytes of stack space for the open containers before the resource is used.
+    static constexpr size_type inline_scratch_size{2048};
+
+    /// A container being read; its elements are the values, and keys, from these on.
+    struct frame {
+        size_type first_value;
+        size_type first_key;
+    };
+
+    std::pmr::memory_resource* resource_;
+    json root_;
+    alignas(std::max_align_t) std::byte inline_scratch_[inline_scratch_size];
+    std::pmr::monotonic_buffer_resource scratch_;
+    /// Open containers, innermost last.
+    std::pmr::vector<frame> stack_;
+    /// Elements and member values of the open containers, in order.
+    std::pmr::vector<json> values_;
+    /// Keys of the members in values_, allocated from resource_ unless interned.
+    std::pmr::vector<json_key> keys_;
+    json_key_pool* key_pool_{};
+
+public:
+    explicit json_builder(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    explicit json_builder(json_key_pool& keys,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    json_builder(const json_builder&) = delete;
+    json_builder& operator=(const json_builder&) = delete;
+
+    ~json_builder() override;
+
+    bool on_null() override;
+    bool on_bool(bool value) override;
+    bool on_number(std::int64_t value) override;
+    bool on_number(double value) override;
+    bool on_string(std::string_view value) override;
+
+    bool on_start_object() override;
+    bool on_key(std::string_view key) override;
+    bool on_end_object() override;
+
+    bool on_start_array() override;
+    bool on_end_array() override;
+
+    /// The value built; complete once the parse has succeeded.
+    json& result();
+
+private:
+    /// The slot for the next value, which has type; containers are stored once they end.
+    json& next_value(json::class_type type);
+    bool open();
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_BUILDER_H
@@ -0,0 +1,64 @@
+#ifndef WINGMANN_JSONLW_JSON_ERROR_H
+#define WINGMANN_JSONLW_JSON_ERROR_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wingmann {
+
+enum class json_errc : std::uint8_t {
+    none,
+    /// The input ended inside a value.
+    unexpected_end,
+    /// A value was expected but something else was found, or a string holds a raw control
+    /// character.
+    unexpected_character,
+    expected_key,
+    expected_colon,
+    expected_comma_or_brace,
+    expected_comma_or_bracket,
+    invalid_escape,
+    invalid_number,
+    invalid_literal,
+    /// A value that must stand alone, such as a JSON Lines record, is followed by more data.
+    trailing_characters,
+    /// A json_handler callback returned false.
+    cancelled,
+    /// The input file could not be read.
+    io_error,
+    /// A value does not fit the C++ type it is read into, see json_load.
+    type_mismatch,
+    /// The data is not a snapshot written by json::dump_snapshot on this platform.
+    invalid_snapshot,
+    /// Arrays and objects are nested deeper than json::max_depth.
+    depth_exceeded
+};
+
+/**
+ * Outcome of a parse. Filled in by the load and parse overloads that take one; on failure
+ * parsing stops at the first error and the position of that error is recorded.
+ *
+ * Nothing is logged, and line and column are only worked out once an error has occurred.
+ */
+struct json_error {
+    json_errc code{json_errc::none};
+    /// Byte offset of the error in the input.
+    std::size_t offset{};
+    /// Line of the error, counting from one.
+    std::size_t line{};
+    /// Byte in that line, counting from one.
+    std::size_t column{};
+
+    /// True when there is an error.
+    explicit operator bool() const
+    {
+        return code != json_errc::none;
+    }
+
+    /// Static description of code, for logs and messages.
+    [[nodiscard]] const char* message() const;
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_ERROR_H
@@ -0,0 +1,69 @@
+#ifndef WINGMANN_JSONLW_JSON_HANDLER_H
+#define WINGMANN_JSONLW_JSON_HANDLER_H
+
+#include "json_sink.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace wingmann {
+
+/**
+ * Receives the events of json::parse in document order.
+ *
+ * Every callback returns whether parsing should go on; returning false stops it.
+ * The string_view arguments are only valid during the call, as they may point into the input
+ * or into a scratch buffer that the next string reuses.
+ * The defaults accept and ignore everything, so a handler only overrides what it needs.
+ */
+class json_handler {
+public:
+    virtual ~json_handler() = default;
+
+    virtual bool on_null();
+    virtual bool on_bool(bool value);
+    virtual bool on_number(std::int64_t value);
+    virtual bool on_number(double value);
+    virtual bool on_string(std::string_view value);
+
+    virtual bool on_start_object();
+    virtual bool on_key(std::string_view key);
+    virtual bool on_end_object();
+
+    virtual bool on_start_array();
+    virtual bool on_end_array();
+};
+
+/// Writes the events it receives as compact JSON, so a document can be filtered or
+/// re-serialized with memory bounded by its nesting depth.
+class json_event_writer : public json_handler {
+private:
+    json_sink& sink_;
+    /// One entry per open container: whether the next member needs a leading comma.
+    std::vector<bool> separate_;
+    bool after_key_{};
+
+public:
+    explicit json_event_writer(json_sink& sink);
+
+    bool on_null() override;
+    bool on_bool(bool value) override;
+    bool on_number(std::int64_t value) override;
+    bool on_number(double value) override;
+    bool on_string(std::string_view value) override;
+
+    bool on_start_object() override;
+    bool on_key(std::string_view key) override;
+    bool on_end_object() override;
+
+    bool on_start_array() override;
+    bool on_end_array() override;
+
+private:
+    void begin_value();
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_HANDLER_H
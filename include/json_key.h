@@ -0,0 +1,159 @@
+#ifndef WINGMANN_JSONLW_JSON_KEY_H
+#define WINGMANN_JSONLW_JSON_KEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <ostream>
+#include <string_view>
+
+namespace wingmann {
+
+class json_key_pool;
+
+/**
+ * Name of an object member.
+ *
+ * Short keys are stored inline, longer ones in a buffer from the object's resource. Keys
+ * interned by a json_key_pool only point to the canonical copy held by the pool, so a key
+ * shared by many objects is stored once.
+ *
+ * Keys do not free their buffer themselves: json_object, which knows the resource, does.
+ */
+class json_key {
+public:
+    using size_type = std::size_t;
+
+    /// Longest key stored without a buffer.
+    static constexpr size_type inline_capacity{16};
+
+private:
+    enum class storage : std::uint8_t { inline_text, owned, interned };
+
+    union {
+        const char* pointer_;
+        char inline_[inline_capacity];
+    };
+    std::uint32_t size_{};
+    storage storage_{storage::inline_text};
+
+    friend class json_key_pool;
+
+    /// Refers to text, which the caller keeps alive for as long as the key is used.
+    explicit json_key(std::string_view text, storage kind)
+        : pointer_{text.data()}, size_{static_cast<std::uint32_t>(text.size())}, storage_{kind}
+    {
+    }
+
+public:
+    json_key() : inline_{}
+    {
+    }
+
+    /// Copies text, into a buffer from resource when it does not fit inline.
+    json_key(std::string_view text, std::pmr::memory_resource* resource)
+        : inline_{}, size_{static_cast<std::uint32_t>(text.size())}
+    {
+        if (text.size() <= inline_capacity) {
+            std::memcpy(inline_, text.data(), text.size());
+            return;
+        }
+        auto* buffer = static_cast<char*>(resource->allocate(text.size(), 1));
+        std::memcpy(buffer, text.data(), text.size());
+        pointer_ = buffer;
+        storage_ = storage::owned;
+    }
+
+    /// Copy of the key for an object whose buffers come from resource. Interned keys stay shared.
+    [[nodiscard]] json_key copy(std::pmr::memory_resource* resource) const
+    {
+        return (storage_ == storage::owned) ? json_key{view(), resource} : *this;
+    }
+
+    /// Frees the buffer of the key, which must have been allocated from resource.
+    void destroy(std::pmr::memory_resource* resource) noexcept
+    {
+        if (storage_ == storage::owned)
+            resource->deallocate(const_cast<char*>(pointer_), size_, 1);
+    }
+
+    [[nodiscard]] const char* data() const
+    {
+        return (storage_ == storage::inline_text) ? inline_ : pointer_;
+    }
+
+    [[nodiscard]] size_type size() const
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    /// Whether the key is the canonical copy held by a json_key_pool.
+    [[nodiscard]] bool interned() const
+    {
+        return storage_ == storage::interned;
+    }
+
+    [[nodiscard]] std::string_view view() const
+    {
+        return {data(), size_};
+    }
+
+    operator std::string_view() const
+    {
+        return view();
+    }
+
+    /// Equal keys of the same pool share their text, so comparing the pointers settles most cases.
+    [[nodiscard]] bool equals(std::string_view text) const
+    {
+        return ((data() == text.data()) && (size_ == text.size())) || (view() == text);
+    }
+
+    friend bool operator==(const json_key& lhs, const json_key& rhs)
+    {
+        return lhs.equals(rhs.view());
+    }
+
+    friend bool operator!=(const json_key& lhs, const json_key& rhs)
+    {
+        return !lhs.equals(rhs.view());
+    }
+
+    friend bool operator==(const json_key& lhs, std::string_view rhs)
+    {
+        return lhs.equals(rhs);
+    }
+
+    friend bool operator==(std::string_view lhs, const json_key& rhs)
+    {
+        return rhs.equals(lhs);
+    }
+
+    friend bool operator!=(const json_key& lhs, std::string_view rhs)
+    {
+        return !lhs.equals(rhs);
+    }
+
+    friend bool operator!=(std::string_view lhs, const json_key& rhs)
+    {
+        return !rhs.equals(lhs);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const json_key& key)
+    {
+        return os << key.view();
+    }
+};
+
+// Objects store a key per member, so keep it smaller than the std::pmr::string it replaces.
+static_assert(sizeof(json_key) <= 24, "json_key layout grew");
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_KEY_H
@@ -0,0 +1,59 @@
+#ifndef WINGMANN_JSONLW_JSON_KEY_POOL_H
+#define WINGMANN_JSONLW_JSON_KEY_POOL_H
+
+#include "json_key.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_set>
+
+namespace wingmann {
+
+/**
+ * Table of canonical object keys, shared by the documents loaded with it.
+ *
+ * Documents with a common schema, such as log records, repeat the same few keys millions of
+ * times. Loaded with a pool, each distinct key is stored once and every member refers to that
+ * copy, so members need no key buffer and lookups with an interned key compare a pointer.
+ *
+ * Keys are never removed. The pool may be used by several threads at once, like the parallel
+ * loaders do; each thread keeps the keys it interned lately in a small cache of its own, so a
+ * repeated key is found without taking the pool's lock.
+ *
+ * @warning Documents loaded with a pool, and their copies, refer to its keys, so the pool must
+ * outlive them.
+ */
+class json_key_pool {
+public:
+    using size_type = std::size_t;
+
+private:
+    /// Identifies the pool in the per-thread caches; never reused, unlike its address.
+    const std::uint64_t id_;
+    mutable std::shared_mutex mutex_;
+    std::pmr::monotonic_buffer_resource text_;
+    std::pmr::unordered_set<std::string_view> keys_;
+
+public:
+    explicit json_key_pool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    json_key_pool(const json_key_pool&) = delete;
+    json_key_pool& operator=(const json_key_pool&) = delete;
+
+    /// The canonical key with the text of key, added on first use.
+    json_key intern(std::string_view key);
+
+    /// Number of distinct keys.
+    [[nodiscard]] size_type size() const;
+
+private:
+    /// The canonical text of key, looked up and, on first use, added under the pool's lock.
+    std::string_view find_or_add(std::string_view key);
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_KEY_POOL_H
@@ -0,0 +1,278 @@
+#ifndef WINGMANN_JSONLW_JSON_OBJECT_H
+#define WINGMANN_JSONLW_JSON_OBJECT_H
+
+#include "json_key.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace wingmann {
+
+/**
+ * Object storage for json: members live in one vector in insertion order.
+ *
+ * Small objects are searched linearly, which beats any tree or hash at that size.
+ * Once an object grows past linear_search_limit members, an open-addressing hash index
+ * of the vector is kept alongside it. Lookups take std::string_view and never allocate.
+ *
+ * Keys are json_key: short ones are stored in the member itself, and keys interned by a
+ * json_key_pool are shared with every other object that uses them.
+ *
+ * @warning Keys are exposed through the iterators for reading only; changing one
+ * breaks lookups.
+ */
+template<typename mapped_type>
+class json_object {
+public:
+    using key_type = json_key;
+    using value_type = std::pair<key_type, mapped_type>;
+    using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+    using container_type = std::pmr::vector<value_type>;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+    using size_type = std::size_t;
+
+    static constexpr size_type linear_search_limit{8};
+
+private:
+    struct slot {
+        std::uint32_t hash;
+        /// Index of the member plus one, zero for an empty slot.
+        std::uint32_t entry;
+    };
+
+    static constexpr size_type npos{static_cast<size_type>(-1)};
+    static constexpr size_type min_index_size{32};
+
+    container_type entries_;
+    std::pmr::vector<slot> index_;
+
+public:
+    json_object() = default;
+
+    explicit json_object(const allocator_type& allocator) : entries_{allocator}, index_{allocator}
+    {
+    }
+
+    json_object(const json_object& other, const allocator_type& allocator)
+        : entries_{other.entries_, allocator}, index_{other.index_, allocator}
+    {
+        // The copied keys still share the buffers of other.
+        size_type copied{};
+        try {
+            for (; copied < entries_.size(); ++copied)
+                entries_[copied].first = entries_[copied].first.copy(resource());
+        }
+        catch (...) {
+            for (size_type i = 0; i < copied; ++i)
+                entries_[i].first.destroy(resource());
+            throw;
+        }
+    }
+
+    json_object(json_object&& other) = default;
+
+    json_object(const json_object&) = delete;
+    json_object& operator=(const json_object&) = delete;
+    json_object& operator=(json_object&&) = delete;
+
+    ~json_object()
+    {
+        for (auto& entry : entries_)
+            entry.first.destroy(resource());
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const
+    {
+        return entries_.get_allocator();
+    }
+
+    iterator begin()
+    {
+        return entries_.begin();
+    }
+
+    iterator end()
+    {
+        return entries_.end();
+    }
+
+    [[nodiscard]] const_iterator begin() const
+    {
+        return entries_.begin();
+    }
+
+    [[nodiscard]] const_iterator end() const
+    {
+        return entries_.end();
+    }
+
+    [[nodiscard]] size_type size() const
+    {
+        return entries_.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return entries_.empty();
+    }
+
+    void reserve(size_type capacity)
+    {
+        entries_.reserve(capacity);
+        if (capacity > linear_search_limit)
+            rebuild_index(index_size_for(capacity));
+    }
+
+    iterator find(std::string_view key)
+    {
+        auto i = find_entry(key);
+        return (i == npos) ? entries_.end() : entries_.begin() + static_cast<std::ptrdiff_t>(i);
+    }
+
+    [[nodiscard]] const_iterator find(std::string_view key) const
+    {
+        auto i = find_entry(key);
+        return (i == npos) ? entries_.end() : entries_.begin() + static_cast<std::ptrdiff_t>(i);
+    }
+
+    /// Returns the member named key, appending a default-constructed one if there is none.
+    mapped_type& operator[](std::string_view key)
+    {
+        auto i = find_entry(key);
+        if (i != npos)
+            return entries_[i].second;
+        return append(key_type{key, resource()});
+    }
+
+    /// Like operator[] with a string, but an interned key is stored without copying its text.
+    mapped_type& operator[](const key_type& key)
+    {
+        auto i = find_entry(key.view());
+        if (i != npos)
+            return entries_[i].second;
+        return append(key.copy(resource()));
+    }
+
+    /**
+     * Appends count members, pairing the keys from keys with the values moved from values,
+     * after growing the object once. The keys must have been allocated from the resource of the
+     * object, which takes them over; a repeated key replaces the value of the earlier member.
+     */
+    template<typename KeyIterator, typename ValueIterator>
+    void adopt(KeyIterator keys, ValueIterator values, size_type count)
+    {
+        reserve(entries_.size() + count);
+
+        for (size_type n = 0; n < count; ++n, ++keys, ++values) {
+            auto i = find_entry(keys->view());
+            if (i != npos) {
+                entries_[i].second = *values;
+                keys->destroy(resource());
+                continue;
+            }
+            entries_.emplace_back(std::piecewise_construct,
+                                  std::forward_as_tuple(*keys),
+                                  std::forward_as_tuple(*values));
+            index_entry(entries_.size() - 1);
+        }
+    }
+
+private:
+    [[nodiscard]] std::pmr::memory_resource* resource() const
+    {
+        return entries_.get_allocator().resource();
+    }
+
+    mapped_type& append(const key_type& key)
+    {
+        try {
+            entries_.emplace_back(
+                std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+        }
+        catch (...) {
+            auto copy = key;
+            copy.destroy(resource());
+            throw;
+        }
+        index_entry(entries_.size() - 1);
+        return entries_.back().second;
+    }
+
+    static std::uint32_t hash_of(std::string_view key)
+    {
+        auto hash = static_cast<std::uint64_t>(std::hash<std::string_view>{}(key));
+        return static_cast<std::uint32_t>(hash ^ (hash >> 32));
+    }
+
+    static size_type index_size_for(size_type members)
+    {
+        // Keep the load factor at or below one half.
+        size_type size{min_index_size};
+        while (size < members * 2)
+            size *= 2;
+        return size;
+    }
+
+    size_type find_entry(std::string_view key) const
+    {
+        if (index_.empty()) {
+            for (size_type i = 0; i < entries_.size(); ++i) {
+                if (entries_[i].first.equals(key))
+                    return i;
+            }
+            return npos;
+        }
+
+        const auto hash = hash_of(key);
+        const auto mask = index_.size() - 1;
+
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            const auto& s = index_[i];
+            if (s.entry == 0)
+                return npos;
+            if ((s.hash == hash) && entries_[s.entry - 1].first.equals(key))
+                return s.entry - 1;
+        }
+    }
+
+    void insert_slot(std::uint32_t hash, size_type entry)
+    {
+        const auto mask = index_.size() - 1;
+        auto i = hash & mask;
+
+        while (index_[i].entry != 0)
+            i = (i + 1) & mask;
+        index_[i] = slot{hash, static_cast<std::uint32_t>(entry + 1)};
+    }
+
+    void rebuild_index(size_type size)
+    {
+        index_.assign(size, slot{});
+        for (size_type i = 0; i < entries_.size(); ++i)
+            insert_slot(hash_of(entries_[i].first.view()), i);
+    }
+
+    void index_entry(size_type entry)
+    {
+        // An index built ahead by reserve covers small objects too.
+        if (index_.empty() && (entries_.size() <= linear_search_limit))
+            return;
+
+        if (index_.size() < entries_.size() * 2)
+            rebuild_index(index_size_for(entries_.size()));
+        else
+            insert_slot(hash_of(entries_[entry].first.view()), entry);
+    }
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_OBJECT_H
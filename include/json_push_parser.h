@@ -0,0 +1,119 @@
+#ifndef WINGMANN_JSONLW_JSON_PUSH_PARSER_H
+#define WINGMANN_JSONLW_JSON_PUSH_PARSER_H
+
+#include "json_error.h"
+#include "json_handler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wingmann {
+
+/**
+ * Incremental parser for input that arrives in pieces, such as socket reads.
+ *
+ * Each chunk passed to feed is parsed right away and reported to the handler; a chunk may end
+ * anywhere, including inside a string, an escape, a number or a literal. Use json_builder as the
+ * handler to get a json. Chunks only need to live for the duration of the feed call.
+ *
+ * Parsing stops after the first complete value; anything fed after it is ignored.
+ */
+class json_push_parser {
+public:
+    using size_type = std::size_t;
+
+private:
+    enum class state : std::uint8_t {
+        value,
+        first_element_or_end,
+        first_key_or_end,
+        key,
+        colon,
+        comma_or_end,
+        string,
+        escape,
+        unicode,
+        number,
+        literal,
+        done,
+        failed
+    };
+
+    json_handler& handler_;
+    state state_{state::value};
+    /// Open containers, innermost last: '{' or '['.
+    std::vector<char> containers_;
+    /// Characters of a string or number that spans chunks, or that contains escapes.
+    std::string token_;
+    const char* literal_{};
+    size_type literal_position_{};
+    unsigned unicode_digits_{};
+    std::uint32_t unicode_value_{};
+    /// High half of a surrogate pair whose low half may follow as the next escape, or zero.
+    std::uint32_t high_surrogate_{};
+    bool is_key_{};
+    /// Offset of the number being read, which may have started in an earlier chunk.
+    size_type number_start_{};
+    /// Bytes in the chunks before the current one, and the lines they ended.
+    size_type consumed_{};
+    size_type lines_{};
+    /// Offset of the first byte after the last newline fed so far.
+    size_type line_start_{};
+    /// The chunk being parsed, for working out error positions in it.
+    const char* chunk_{};
+    json_error error_;
+
+public:
+    explicit json_push_parser(json_handler& handler);
+
+    /// Parses the next chunk. Returns false once a syntax error occurred or the handler stopped.
+    bool feed(const char* data, size_type size);
+    bool feed(std::string_view data);
+
+    /**
+     * Signals the end of the input, which completes a number at the very end of it.
+     * Returns whether a whole value has been read.
+     */
+    bool finish();
+
+    /// Whether a whole value has been read.
+    [[nodiscard]] bool done() const;
+
+    /**
+     * Why feed or finish returned false, with its position in the whole input fed so far.
+     * A cancellation is placed at the start of the chunk in which the handler stopped.
+     */
+    [[nodiscard]] const json_error& error() const;
+
+    /// Prepares the parser for a new document, reporting to the same handler.
+    void reset();
+
+private:
+    bool parse_chunk(const char* data, size_type size);
+    /// Offset of p, a position in the current chunk, in the whole input.
+    [[nodiscard]] size_type offset_of(const char* p) const;
+    bool fail(json_errc code, size_type offset);
+    /// Passes on a callback's result, stopping the parse when it is false.
+    bool emit(bool go_on);
+    void end_value();
+
+    bool start_value(const char*& p);
+    void start_string(bool is_key);
+    bool end_string(std::string_view value);
+    bool parse_string(const char*& p, const char* end);
+    bool parse_escape(const char*& p);
+    bool parse_unicode_digit(const char*& p);
+    /// Writes a pending high surrogate, which no low one followed, as U+FFFD.
+    void end_surrogate();
+    bool parse_number(const char*& p, const char* end);
+    /// Completes the number; next is the character after it, or null at the end of the input.
+    bool end_number(const char* next);
+    bool parse_literal(const char*& p);
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_PUSH_PARSER_H
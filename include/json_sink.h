@@ -0,0 +1,73 @@
+#ifndef WINGMANN_JSONLW_JSON_SINK_H
+#define WINGMANN_JSONLW_JSON_SINK_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace wingmann {
+
+/**
+ * Output target of the serializer.
+ *
+ * Text is appended to a single buffer: either a caller-owned string, which is never flushed,
+ * or an internal one that is handed to a stream or file descriptor each time it fills up.
+ */
+class json_sink {
+public:
+    using size_type = std::size_t;
+
+    static constexpr size_type default_buffer_size{64 * 1024};
+
+private:
+    std::string local_;
+    std::string* buffer_;
+    std::ostream* stream_{};
+    int fd_{-1};
+    size_type flush_threshold_{std::numeric_limits<size_type>::max()};
+    bool good_{true};
+
+public:
+    explicit json_sink(std::string& buffer);
+    explicit json_sink(std::ostream& stream, size_type buffer_size = default_buffer_size);
+    explicit json_sink(int fd, size_type buffer_size = default_buffer_size);
+
+    json_sink(const json_sink&) = delete;
+    json_sink& operator=(const json_sink&) = delete;
+
+    ~json_sink();
+
+    void put(char c)
+    {
+        buffer_->push_back(c);
+        if (buffer_->size() >= flush_threshold_)
+            flush();
+    }
+
+    void write(const char* data, size_type size)
+    {
+        buffer_->append(data, size);
+        if (buffer_->size() >= flush_threshold_)
+            flush();
+    }
+
+    void write(std::string_view value)
+    {
+        write(value.data(), value.size());
+    }
+
+    /**
+     * Hands buffered text to the stream or file descriptor.
+     * Does nothing when writing into a caller-owned string.
+     */
+    void flush();
+
+    /// False once a write to the underlying stream or file descriptor has failed.
+    [[nodiscard]] bool good() const;
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_SINK_H
@@ -0,0 +1,73 @@
+#ifndef WINGMANN_JSONLW_JSON_STATS_H
+#define WINGMANN_JSONLW_JSON_STATS_H
+
+#include "json.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace wingmann {
+
+/**
+ * What one call of the load and dump overloads that take it did: how much it read or wrote,
+ * the shape of the document and where the time went.
+ *
+ * Only bytes is filled in unless the library is built with JSONLW_ENABLE_STATS (the CMake
+ * option of the same name). Without it the counters are never touched and the parser and the
+ * serializer contain no trace of them, so the overloads can stay in release builds.
+ *
+ * A load counts the nodes it builds and the allocations made from its resource, including
+ * scratch space; the durations are spent in parse_string, in parse_number, and in building
+ * arrays and objects once their last element is read. A dump counts the nodes it writes and
+ * times escaping strings and formatting numbers; it allocates through its buffer only, which
+ * is not counted, and leaves container_time zero.
+ *
+ * The overloads that take a json_thread_pool also count what its workers do. The durations are
+ * then added up over all the threads, so they may exceed total_time, which is the wall time.
+ *
+ * @warning With JSONLW_ENABLE_STATS the resource of a load is reached through a counting
+ * wrapper that lives until the program ends, one per resource ever passed to these overloads.
+ */
+struct json_stats {
+    using size_type = json::size_type;
+    using duration = std::chrono::nanoseconds;
+
+#ifdef JSONLW_ENABLE_STATS
+    static constexpr bool enabled{true};
+#else
+    static constexpr bool enabled{false};
+#endif
+
+    /// Input read up to the end or the error, or output written.
+    size_type bytes{};
+    /// Nodes by type, indexed by json::class_type.
+    std::array<size_type, 7> nodes{};
+    /// Deepest nesting; a scalar at the top is at depth one.
+    size_type max_depth{};
+    size_type allocations{};
+    size_type allocated_bytes{};
+
+    duration string_time{};
+    duration number_time{};
+    duration container_time{};
+    /// The whole call, including what is not split out above.
+    duration total_time{};
+
+    [[nodiscard]] size_type node_count(json::class_type type) const
+    {
+        return nodes[static_cast<size_type>(type)];
+    }
+
+    [[nodiscard]] size_type node_count() const
+    {
+        size_type total{};
+        for (auto count : nodes)
+            total += count;
+        return total;
+    }
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_STATS_H
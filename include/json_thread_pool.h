@@ -0,0 +1,108 @@
+#ifndef WINGMANN_JSONLW_JSON_THREAD_POOL_H
+#define WINGMANN_JSONLW_JSON_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wingmann {
+
+/**
+ * Worker threads for the parallel loaders and serializers.
+ *
+ * Every worker has its own task queue. It takes work from the back of it and, once it runs dry,
+ * steals from the front of the others, so uneven tasks such as records of very different sizes
+ * still keep all workers busy.
+ *
+ * A thread waiting in parallel_for runs queued tasks instead of blocking, so parallel_for may be
+ * called from inside a task.
+ */
+class json_thread_pool {
+public:
+    using size_type = std::size_t;
+    using range_task = std::function<void(size_type first, size_type last)>;
+
+    class job;
+
+private:
+    struct task_queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<task_queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_type> pending_{};
+    std::atomic<size_type> next_queue_{};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stop_{};
+
+public:
+    /// Starts threads workers; zero means one per hardware thread.
+    explicit json_thread_pool(unsigned threads = 0);
+
+    json_thread_pool(const json_thread_pool&) = delete;
+    json_thread_pool& operator=(const json_thread_pool&) = delete;
+
+    ~json_thread_pool();
+
+    /// Number of worker threads.
+    [[nodiscard]] size_type size() const;
+
+    /**
+     * Calls task on consecutive ranges covering [0, count), each at least grain long except
+     * the last, and returns when all of them have finished. The first exception thrown by a
+     * task is rethrown here.
+     */
+    void parallel_for(size_type count, const range_task& task, size_type grain = 1);
+
+    /**
+     * Starts task on ranges like parallel_for, without waiting for them, so the calling thread
+     * can do other work meanwhile. The ranges are finished once the returned job is waited for
+     * or destroyed; what task refers to must live until then.
+     */
+    [[nodiscard]] job start_for(size_type count, range_task task, size_type grain = 1);
+
+private:
+    void submit(std::function<void()> task);
+    bool run_one(size_type home);
+    void work(size_type index);
+};
+
+/// Ranges started by json_thread_pool::start_for.
+class json_thread_pool::job {
+private:
+    struct state;
+
+    json_thread_pool* pool_{};
+    std::shared_ptr<state> state_;
+
+    friend class json_thread_pool;
+
+    job(json_thread_pool& pool, std::shared_ptr<state> state);
+
+public:
+    job() = default;
+    job(job&& other) noexcept = default;
+    /// Waits for the ranges of this job, dropping any exception, before taking those of other.
+    job& operator=(job&& other) noexcept;
+    /// Waits for the ranges unless wait was called; an exception thrown by them is dropped.
+    ~job();
+
+    /**
+     * Runs queued tasks until all the ranges have finished. The first exception thrown by a
+     * range is rethrown here.
+     */
+    void wait();
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_THREAD_POOL_H
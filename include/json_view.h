@@ -0,0 +1,256 @@
+#ifndef WINGMANN_JSONLW_JSON_VIEW_H
+#define WINGMANN_JSONLW_JSON_VIEW_H
+
+#include "json.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace wingmann {
+
+namespace detail {
+class mapped_file;
+} // namespace detail
+
+/**
+ * Read-only value inside a snapshot written by json::dump_snapshot.
+ *
+ * A view is read in place: nothing is parsed or allocated, array elements are indexed directly
+ * and the members of large objects are found by binary search. The accessors behave like those
+ * of json with the same name. A default-constructed view is null.
+ *
+ * @warning A view points into its snapshot, which must outlive it.
+ */
+class json_view {
+public:
+    using size_type = std::size_t;
+    using int_type = json::int_type;
+    using float_type = json::float_type;
+    using class_type = json::class_type;
+
+    /// Bytes taken by each value in a snapshot; an object member takes two, key first.
+    static constexpr size_type slot_size{16};
+
+    class array_iterator;
+    class object_iterator;
+    template<typename Iterator>
+    class range;
+
+private:
+    /// Start of the snapshot, which offsets are relative to.
+    const char* base_{};
+    /// Slot of the value, or nullptr for a null view.
+    const char* slot_{};
+
+    friend class json_snapshot;
+
+    json_view(const char* base, const char* slot) : base_{base}, slot_{slot}
+    {
+    }
+
+public:
+    json_view() = default;
+
+    [[nodiscard]] json_view at(std::string_view key) const;
+    [[nodiscard]] json_view at(unsigned index) const;
+
+    [[nodiscard]] size_type length() const;
+
+    [[nodiscard]] bool has_key(std::string_view key) const;
+
+    [[nodiscard]] size_type size() const;
+
+    [[nodiscard]] class_type json_type() const;
+
+    [[nodiscard]] bool is_null() const;
+
+    [[nodiscard]] std::string to_string() const;
+    std::string to_string(bool& ok) const;
+
+    /// Text of a string value as stored in the snapshot, without copying it.
+    [[nodiscard]] std::string_view string_view() const;
+
+    [[nodiscard]] float_type to_float() const;
+    float_type to_float(bool& ok) const;
+
+    [[nodiscard]] int_type to_int() const;
+    int_type to_int(bool& ok) const;
+
+    [[nodiscard]] bool to_bool() const;
+    bool to_bool(bool& ok) const;
+
+    /// Elements of an array; empty for other types.
+    [[nodiscard]] range<array_iterator> array_range() const;
+
+    /// Members of an object as (key, value) pairs in insertion order; empty for other types.
+    [[nodiscard]] range<object_iterator> object_range() const;
+
+private:
+    /// Slot of the value of the member named key, or nullptr.
+    [[nodiscard]] const char* find(std::string_view key) const;
+    /// First slot of the elements or members, and their count; nullptr unless type matches.
+    [[nodiscard]] const char* children(class_type type, size_type& count) const;
+};
+
+template<typename Iterator>
+class json_view::range {
+private:
+    Iterator first_;
+    Iterator last_;
+
+public:
+    range(Iterator first, Iterator last) : first_{first}, last_{last}
+    {
+    }
+
+    [[nodiscard]] Iterator begin() const
+    {
+        return first_;
+    }
+
+    [[nodiscard]] Iterator end() const
+    {
+        return last_;
+    }
+};
+
+class json_view::array_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = json_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const json_view*;
+    using reference = json_view;
+
+private:
+    const char* base_{};
+    const char* slot_{};
+
+public:
+    array_iterator() = default;
+
+    array_iterator(const char* base, const char* slot) : base_{base}, slot_{slot}
+    {
+    }
+
+    json_view operator*() const
+    {
+        return {base_, slot_};
+    }
+
+    array_iterator& operator++()
+    {
+        slot_ += slot_size;
+        return *this;
+    }
+
+    array_iterator operator++(int)
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    friend bool operator==(const array_iterator& lhs, const array_iterator& rhs)
+    {
+        return lhs.slot_ == rhs.slot_;
+    }
+
+    friend bool operator!=(const array_iterator& lhs, const array_iterator& rhs)
+    {
+        return lhs.slot_ != rhs.slot_;
+    }
+};
+
+class json_view::object_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<std::string_view, json_view>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = value_type;
+
+private:
+    const char* base_{};
+    const char* slot_{};
+
+public:
+    object_iterator() = default;
+
+    object_iterator(const char* base, const char* slot) : base_{base}, slot_{slot}
+    {
+    }
+
+    value_type operator*() const
+    {
+        return {json_view{base_, slot_}.string_view(), json_view{base_, slot_ + slot_size}};
+    }
+
+    object_iterator& operator++()
+    {
+        slot_ += 2 * slot_size;
+        return *this;
+    }
+
+    object_iterator operator++(int)
+    {
+        auto copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    friend bool operator==(const object_iterator& lhs, const object_iterator& rhs)
+    {
+        return lhs.slot_ == rhs.slot_;
+    }
+
+    friend bool operator!=(const object_iterator& lhs, const object_iterator& rhs)
+    {
+        return lhs.slot_ != rhs.slot_;
+    }
+};
+
+/**
+ * Snapshot written by json::dump_snapshot, opened for reading through json_view.
+ *
+ * A snapshot is one block of offsets, numbers and text, so opening it takes one pass over its
+ * slots that checks every offset and size against its length, instead of the whole document
+ * being parsed and allocated at startup. Views then read in place and never outside it.
+ *
+ * Snapshots use the byte order of the machine that wrote them; one from a machine with another
+ * byte order, like any other data that is not a snapshot, fails with
+ * json_errc::invalid_snapshot, as does a snapshot with an offset or size out of bounds.
+ */
+class json_snapshot {
+private:
+    std::unique_ptr<detail::mapped_file> file_;
+    std::string_view data_;
+
+public:
+    json_snapshot();
+    json_snapshot(json_snapshot&& other) noexcept;
+    json_snapshot& operator=(json_snapshot&& other) noexcept;
+    ~json_snapshot();
+
+    /// Reads the snapshot in data, which must outlive it, without copying it.
+    static json_snapshot load(std::string_view data);
+    static json_snapshot load(std::string_view data, json_error& error);
+
+    /// Maps the snapshot stored in the file at path.
+    static json_snapshot load_file(const std::string& path);
+    static json_snapshot load_file(const std::string& path, json_error& error);
+
+    /// The document, or a null view when the snapshot could not be opened.
+    [[nodiscard]] json_view root() const;
+
+    /// The bytes of the snapshot.
+    [[nodiscard]] std::string_view data() const;
+};
+
+} // namespace wingmann
+
+#endif // WINGMANN_JSONLW_JSON_VIEW_H
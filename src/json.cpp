@@ -1,79 +1,111 @@
 #include "json.h"
-
+#include "json_builder.h"
+#include "json_key_pool.h"
+#include "json_mapped_file.h"
+#include "json_number.h"
+#include "json_reader.h"
+#include "json_scan.h"
+#include "json_stats_recorder.h"
+#include "json_structural.h"
+#include "json_thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
 #include <limits>
+#include <stdexcept>
 
 using namespace wingmann;
 
-json::backing_data::backing_data(json::float_type value) : json_float{value}
+namespace {
+
+/// Largest structural index, in positions, that a thread keeps for its next load.
+constexpr std::size_t max_kept_index_size{1024 * 1024};
+
+/**
+ * Hands over what builder assembled, or reports where reader stopped and returns null.
+ * Anything but whitespace after the value is json_errc::trailing_characters.
+ */
+template<typename Reader>
+json finish_load(Reader& reader, json_builder& builder, std::string_view value, json_error& error)
+{
+    if (reader.parse() && reader.finish()) {
+        error = {};
+        return std::move(builder.result());
+    }
+    error = detail::locate_error(reader.error(), value, reader.error_offset());
+    return {};
+}
+
+template<typename T, typename... Args>
+T* allocate_node(std::pmr::memory_resource* resource, Args&&... args)
 {
+    std::pmr::polymorphic_allocator<T> allocator{resource};
+    T* node = allocator.allocate(1);
+
+    try {
+        // Passes the allocator on to the container, so its contents use the same resource.
+        allocator.construct(node, std::forward<Args>(args)...);
+    }
+    catch (...) {
+        allocator.deallocate(node, 1);
+        throw;
+    }
+    return node;
+}
+
+template<typename T>
+void deallocate_node(T* node)
+{
+    std::pmr::polymorphic_allocator<T> allocator{node->get_allocator().resource()};
+    node->~T();
+    allocator.deallocate(node, 1);
 }
 
-json::backing_data::backing_data(json::int_type value) : json_int{value}
+} // namespace
+
+json::backing_data::backing_data(json::float_type number) : value{class_type::floating, 0, {}}
 {
+    value.json_float = number;
 }
 
-json::backing_data::backing_data(json::bool_type value) : json_bool{value}
+json::backing_data::backing_data(json::int_type number) : value{class_type::integral, 0, {}}
 {
+    value.json_int = number;
 }
 
-json::backing_data::backing_data(json::string_type value)
-    : json_string{new string_type{std::move(value)}}
+json::backing_data::backing_data(json::bool_type flag) : value{class_type::boolean, 0, {}}
 {
+    value.json_bool = flag;
 }
 
 json::json(std::initializer_list<json> list) : json{}
 {
     set_type(class_type::object);
-    for (auto i = list.begin(), e = list.end(); i != e; ++i, ++i)
-        operator[](i->to_string()) = *std::next(i);
+    for (auto i = list.begin(), e = list.end(); i != e; ++i, ++i) {
+        // Keys are stored as they are and escaped by dump; a key that is not a string is empty.
+        auto key =
+            (i->internal_.value.type == class_type::string) ? i->string_view() : std::string_view{};
+        operator[](key) = *std::next(i);
+    }
 }
 
-json::json(json&& other) noexcept : internal_{other.internal_}, type_{other.type_}
+json::json(json&& other) noexcept : internal_{other.internal_}
 {
-    other.type_ = class_type::null;
-    other.internal_.json_map = nullptr;
+    other.internal_ = backing_data{};
 }
 
 json::json(const json& other)
 {
-    switch (other.type_) {
-    case class_type::object:
-        internal_.json_map =
-            new map_type{other.internal_.json_map->begin(), other.internal_.json_map->end()};
-        break;
-    case class_type::array:
-        internal_.json_list =
-            new list_type{other.internal_.json_list->begin(), other.internal_.json_list->end()};
-        break;
-    case class_type::string:
-        internal_.json_string = new string_type{*other.internal_.json_string};
-        break;
-    default:
-        internal_ = other.internal_;
-        break;
-    }
-    type_ = other.type_;
+    copy_internal(other);
 }
 
-json::json(std::nullptr_t) : internal_{}, type_{class_type::null}
+json::json(std::nullptr_t) : internal_{}
 {
 }
 
 json::~json()
 {
-    switch (type_) {
-    case class_type::array:
-        delete internal_.json_list;
-        break;
-    case class_type::object:
-        delete internal_.json_map;
-        break;
-    case class_type::string:
-        delete internal_.json_string;
-        break;
-    default:
-        break;
-    }
+    clear_internal();
 }
 
 json& json::operator=(json&& other) noexcept
@@ -81,72 +113,182 @@ json& json::operator=(json&& other) noexcept
     clear_internal();
 
     internal_ = other.internal_;
-    type_ = other.type_;
-    other.internal_.json_map = nullptr;
-    other.type_ = class_type::null;
+    other.internal_ = backing_data{};
     return *this;
 }
 
 json& json::operator=(const json& other)
 {
-    clear_internal();
+    if (this == &other)
+        return *this;
 
-    switch (other.type_) {
-    case class_type::object:
-        internal_.json_map =
-            new map_type{other.internal_.json_map->begin(), other.internal_.json_map->end()};
-        break;
-    case class_type::array:
-        internal_.json_list =
-            new list_type{other.internal_.json_list->begin(), other.internal_.json_list->end()};
-        break;
-    case class_type::string:
-        internal_.json_string = new string_type{*other.internal_.json_string};
-        break;
-    default:
-        internal_ = other.internal_;
-        break;
-    }
-    type_ = other.type_;
+    clear_internal();
+    internal_.value.type = class_type::null;
+    copy_internal(other);
     return *this;
 }
 
-json& json::operator[](const string_type& key)
+json& json::operator[](std::string_view key)
 {
     set_type(class_type::object);
-    return internal_.json_map->operator[](key);
+    return internal_.value.json_map->operator[](key);
 }
 
 json& json::operator[](unsigned int index)
 {
     set_type(class_type::array);
-    if (index >= internal_.json_list->size())
-        internal_.json_list->resize(index + 1);
+    if (index >= internal_.value.json_list->size())
+        internal_.value.json_list->resize(index + 1);
 
-    return internal_.json_list->operator[](index);
+    return internal_.value.json_list->operator[](index);
 }
 
-json json::make(json::class_type type)
+void json::reserve(size_type capacity)
+{
+    set_type(class_type::array);
+    internal_.value.json_list->reserve(capacity);
+}
+
+json json::make(json::class_type type, std::pmr::memory_resource* resource)
 {
     json ret;
-    ret.set_type(type);
+    ret.set_type(type, resource);
     return ret;
 }
 
-json json::load(const string_type& value)
+json json::load(std::string_view value, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load(value, error, resource));
+}
+
+json json::load(const char* data, size_type size, std::pmr::memory_resource* resource)
+{
+    return load(std::string_view{data, size}, resource);
+}
+
+json json::load(std::string_view value, json_error& error, std::pmr::memory_resource* resource)
+{
+    json_builder builder{resource};
+    detail::reader<json_builder> reader{value, builder, resource};
+    return std::move(finish_load(reader, builder, value, error));
+}
+
+json json::load(std::string_view value, json_key_pool& keys, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load(value, keys, error, resource));
+}
+
+json json::load(std::string_view value,
+                json_key_pool& keys,
+                json_error& error,
+                std::pmr::memory_resource* resource)
+{
+    json_builder builder{keys, resource};
+    detail::reader<json_builder> reader{value, builder, resource};
+    return std::move(finish_load(reader, builder, value, error));
+}
+
+json json::load(std::string_view value, parser_backend backend, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load(value, backend, error, resource));
+}
+
+json json::load(std::string_view value,
+                parser_backend backend,
+                json_error& error,
+                std::pmr::memory_resource* resource)
+{
+    if ((backend == parser_backend::recursive_descent) || (value.size() > detail::max_indexed_size))
+        return std::move(load(value, error, resource));
+
+    // Reused across calls, so loading many small documents does not allocate an index each time.
+    thread_local std::vector<std::uint32_t> index;
+
+    json_builder builder{resource};
+
+    detail::build_structural_index(value.data(), value.size(), index);
+
+    detail::indexed_reader<json_builder> reader{value, index, builder, resource};
+    auto result = finish_load(reader, builder, value, error);
+
+    if (index.capacity() > max_kept_index_size)
+        std::vector<std::uint32_t>{}.swap(index);
+    return result;
+}
+
+json json::load_file(const string_type& path, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load_file(path, parser_backend::recursive_descent, error, resource));
+}
+
+json json::load_file(const string_type& path,
+                     json_error& error,
+                     std::pmr::memory_resource* resource)
+{
+    return std::move(load_file(path, parser_backend::recursive_descent, error, resource));
+}
+
+json json::load_file(const string_type& path,
+                     parser_backend backend,
+                     std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load_file(path, backend, error, resource));
+}
+
+json json::load_file(const string_type& path,
+                     parser_backend backend,
+                     json_error& error,
+                     std::pmr::memory_resource* resource)
 {
-    size_type offset{};
-    return std::move(parse_next(value, offset));
+    detail::mapped_file file{path};
+
+    if (!file.ok()) {
+        error = json_error{json_errc::io_error};
+        return {};
+    }
+    return std::move(load(file.view(), backend, error, resource));
+}
+
+bool json::parse(std::string_view value, json_handler& handler)
+{
+    json_error error;
+    return parse(value, handler, error);
 }
 
-json& json::at(const string_type& key)
+bool json::parse(std::string_view value, json_handler& handler, json_error& error)
+{
+    detail::reader<json_handler> reader{value, handler};
+
+    if (reader.parse() && reader.finish()) {
+        error = {};
+        return true;
+    }
+    error = detail::locate_error(reader.error(), value, reader.error_offset());
+    return false;
+}
+
+void json::release() noexcept
+{
+    internal_ = backing_data{};
+}
+
+json& json::at(std::string_view key)
 {
     return operator[](key);
 }
 
-const json& json::at(const string_type& key) const
+const json& json::at(std::string_view key) const
 {
-    return internal_.json_map->at(key);
+    auto i = internal_.value.json_map->find(key);
+    if (i == internal_.value.json_map->end())
+        throw std::out_of_range{"json::at: no such key"};
+
+    return i->second;
 }
 
 json& json::at(unsigned int index)
@@ -156,28 +298,28 @@ json& json::at(unsigned int index)
 
 const json& json::at(unsigned int index) const
 {
-    return internal_.json_list->at(index);
+    return internal_.value.json_list->at(index);
 }
 
 json::size_type json::length() const
 {
-    return (type_ == class_type::array) ? internal_.json_list->size()
-                                        : std::numeric_limits<size_type>::max();
+    return (internal_.value.type == class_type::array) ? internal_.value.json_list->size()
+                                                       : std::numeric_limits<size_type>::max();
 }
 
-bool json::has_key(const string_type& key) const
+bool json::has_key(std::string_view key) const
 {
-    return (type_ == class_type::object) &&
-           (internal_.json_map->find(key) != internal_.json_map->end());
+    return (internal_.value.type == class_type::object) &&
+           (internal_.value.json_map->find(key) != internal_.value.json_map->end());
 }
 
 json::size_type json::size() const
 {
-    switch (type_) {
+    switch (internal_.value.type) {
     case class_type::object:
-        return internal_.json_map->size();
+        return internal_.value.json_map->size();
     case class_type::array:
-        return internal_.json_list->size();
+        return internal_.value.json_list->size();
     default:
         return std::numeric_limits<size_type>::max();
     }
@@ -185,12 +327,12 @@ json::size_type json::size() const
 
 json::class_type json::json_type() const
 {
-    return type_;
+    return internal_.value.type;
 }
 
 bool json::is_null() const
 {
-    return type_ == class_type::null;
+    return internal_.value.type == class_type::null;
 }
 
 json::string_type json::to_string() const
@@ -201,8 +343,9 @@ json::string_type json::to_string() const
 
 json::string_type json::to_string(bool& ok) const
 {
-    return (ok = type_ == class_type::string) ? std::move(json_escape(*internal_.json_string))
-                                              : string_type{};
+    return (ok = internal_.value.type == class_type::string)
+               ? std::move(json_escape(string_view()))
+               : string_type{};
 }
 
 double json::to_float() const
@@ -213,7 +356,8 @@ double json::to_float() const
 
 double json::to_float(bool& ok) const
 {
-    return (ok = type_ == class_type::floating) ? internal_.json_float : double{};
+    return (ok = internal_.value.type == class_type::floating) ? internal_.value.json_float
+                                                               : double{};
 }
 
 json::int_type json::to_int() const
@@ -224,7 +368,8 @@ json::int_type json::to_int() const
 
 json::int_type json::to_int(bool& ok) const
 {
-    return (ok = type_ == class_type::integral) ? internal_.json_int : int_type{};
+    return (ok = internal_.value.type == class_type::integral) ? internal_.value.json_int
+                                                               : int_type{};
 }
 
 bool json::to_bool() const
@@ -235,81 +380,207 @@ bool json::to_bool() const
 
 bool json::to_bool(bool& ok) const
 {
-    return (ok = type_ == class_type::boolean) && internal_.json_bool;
+    return (ok = internal_.value.type == class_type::boolean) && internal_.value.json_bool;
 }
 
-auto json::array_range()
+json::json_list_wraper_type json::array_range()
 {
-    return (type_ == class_type::array) ? json_list_wraper_type{internal_.json_list}
-                                        : json_list_wraper_type{nullptr};
+    return (internal_.value.type == class_type::array)
+               ? json_list_wraper_type{internal_.value.json_list}
+               : json_list_wraper_type{nullptr};
 }
 
-auto json::array_range() const
+json::json_const_list_wraper_type json::array_range() const
 {
-    return (type_ == class_type::array) ? json_const_list_wraper_type{internal_.json_list}
-                                        : json_const_list_wraper_type{nullptr};
+    return (internal_.value.type == class_type::array)
+               ? json_const_list_wraper_type{internal_.value.json_list}
+               : json_const_list_wraper_type{nullptr};
 }
 
-auto json::object_range()
+json::json_map_wraper_type json::object_range()
 {
-    return (type_ == class_type::object) ? json_map_wraper_type{internal_.json_map}
-                                         : json_map_wraper_type{nullptr};
+    return (internal_.value.type == class_type::object)
+               ? json_map_wraper_type{internal_.value.json_map}
+               : json_map_wraper_type{nullptr};
 }
 
-auto json::object_range() const
+json::json_const_map_wraper_type json::object_range() const
 {
-    return (type_ == class_type::array) ? json_const_map_wraper_type{internal_.json_map}
-                                        : json_const_map_wraper_type{nullptr};
+    return (internal_.value.type == class_type::object)
+               ? json_const_map_wraper_type{internal_.value.json_map}
+               : json_const_map_wraper_type{nullptr};
 }
 
 json::string_type json::dump(int depth, const string_type& tab) const
 {
-    string_type pad;
-    for (int i = 0; i < depth; ++i, pad += tab) {}
+    string_type output;
+    json_sink sink{output};
+    serialize(sink, dump_style::pretty, tab, depth);
+    return output;
+}
+
+void json::dump(json_sink& sink, dump_style style, std::string_view tab) const
+{
+    serialize(sink, style, tab, 1);
+}
+
+void json::dump(string_type& buffer, dump_style style, std::string_view tab) const
+{
+    json_sink sink{buffer};
+    serialize(sink, style, tab, 1);
+}
 
-    switch (type_) {
+void json::dump(json_sink& sink,
+                json_thread_pool& pool,
+                dump_style style,
+                std::string_view tab) const
+{
+    serialize(sink, style, tab, 1, &pool);
+}
+
+void json::dump(string_type& buffer,
+                json_thread_pool& pool,
+                dump_style style,
+                std::string_view tab) const
+{
+    json_sink sink{buffer};
+    serialize(sink, style, tab, 1, &pool);
+}
+
+void json::serialize(json_sink& sink,
+                     dump_style style,
+                     std::string_view tab,
+                     int depth,
+                     json_thread_pool* pool) const
+{
+    detail::stats_nesting nesting{internal_.value.type};
+
+    switch (internal_.value.type) {
     case class_type::null:
-        return "null";
+        sink.write("null");
+        break;
     case class_type::object:
     {
-        string_type s{"{\n"};
-        bool skip{true};
+        if (internal_.value.json_map->empty()) {
+            sink.write("{}");
+            break;
+        }
+        const bool pretty = style == dump_style::pretty;
 
-        for (auto& p : *internal_.json_map) {
-            if (!skip)
-                s += ",\n";
+        sink.write(pretty ? "{\n" : "{");
+        serialize_elements(sink, style, tab, depth, pool);
 
-            s += (pad + "\"" + p.first + "\" : " + p.second.dump(depth + 1, tab));
-            skip = false;
+        if (pretty) {
+            sink.put('\n');
+            for (int i = 1; i < depth; ++i)
+                sink.write(tab);
         }
-        s += ("\n" + pad.erase(0, 2) + "}");
-        return s;
+        sink.put('}');
+        break;
     }
     case class_type::array:
+        sink.put('[');
+        serialize_elements(sink, style, tab, depth, pool);
+        sink.put(']');
+        break;
+    case class_type::string:
     {
-        string_type s{"["};
-        bool skip{true};
-
-        for (auto& p : *internal_.json_list) {
-            if (!skip)
-                s += ", ";
-
-            s += p.dump(depth + 1, tab);
-            skip = false;
-        }
-        s += "]";
-        return s;
+        detail::stats_timer timer{&json_stats::string_time};
+        sink.put('\"');
+        json_escape(sink, string_view());
+        sink.put('\"');
+        break;
     }
-    case class_type::string:
-        return "\"" + json_escape(*internal_.json_string) + "\"";
     case class_type::floating:
-        return std::to_string(internal_.json_float);
+    {
+        detail::stats_timer timer{&json_stats::number_time};
+        char buffer[detail::max_number_chars];
+        auto last = detail::format_double(buffer, internal_.value.json_float);
+        sink.write(buffer, static_cast<size_type>(last - buffer));
+        break;
+    }
     case class_type::integral:
-        return std::to_string(internal_.json_int);
+    {
+        detail::stats_timer timer{&json_stats::number_time};
+        char buffer[detail::max_number_chars];
+        auto last = detail::format_int(buffer, internal_.value.json_int);
+        sink.write(buffer, static_cast<size_type>(last - buffer));
+        break;
+    }
     case class_type::boolean:
-        return internal_.json_bool ? "true" : "false";
-    default:
-        return {};
+        sink.write(internal_.value.json_bool ? "true" : "false");
+        break;
+    }
+}
+
+void json::serialize_elements(json_sink& sink,
+                              dump_style style,
+                              std::string_view tab,
+                              int depth,
+                              json_thread_pool* pool) const
+{
+    const size_type count = size();
+
+    if ((pool == nullptr) || (count < parallel_dump_threshold)) {
+        serialize_range(sink, style, tab, depth, pool, 0, count);
+        return;
+    }
+
+    // Serialize chunks into buffers of their own, then write them out in order.
+    const size_type chunk_size = std::max(parallel_dump_chunk, count / (pool->size() * 8));
+    std::vector<string_type> chunks((count + chunk_size - 1) / chunk_size);
+
+    pool->parallel_for(chunks.size(), [&](size_type first, size_type last) {
+        for (auto i = first; i < last; ++i) {
+            json_sink chunk{chunks[i]};
+            serialize_range(chunk, style, tab, depth, pool, i * chunk_size,
+                            std::min(count, (i + 1) * chunk_size));
+        }
+    });
+
+    for (auto& chunk : chunks)
+        sink.write(chunk);
+}
+
+void json::serialize_range(json_sink& sink,
+                           dump_style style,
+                           std::string_view tab,
+                           int depth,
+                           json_thread_pool* pool,
+                           size_type first,
+                           size_type last) const
+{
+    const bool pretty = style == dump_style::pretty;
+
+    if (internal_.value.type == class_type::object) {
+        auto it = internal_.value.json_map->begin() + static_cast<std::ptrdiff_t>(first);
+
+        for (auto i = first; i < last; ++i, ++it) {
+            if (i != 0)
+                sink.write(pretty ? ",\n" : ",");
+
+            if (pretty) {
+                for (int j = 0; j < depth; ++j)
+                    sink.write(tab);
+            }
+            {
+                detail::stats_timer timer{&json_stats::string_time};
+                sink.put('\"');
+                json_escape(sink, it->first);
+            }
+            sink.write(pretty ? "\" : " : "\":");
+            it->second.serialize(sink, style, tab, depth + 1, pool);
+        }
+        return;
+    }
+
+    auto& list = *internal_.value.json_list;
+
+    for (auto i = first; i < last; ++i) {
+        if (i != 0)
+            sink.write(pretty ? ", " : ",");
+
+        list[i].serialize(sink, style, tab, depth, pool);
     }
 }
 
@@ -323,357 +594,181 @@ json json::object()
     return std::move(json::make(json::class_type::object));
 }
 
-void json::set_type(json::class_type type)
+void json::set_type(json::class_type type, std::pmr::memory_resource* resource)
 {
-    if (type == type_)
+    if (type == internal_.value.type)
         return;
     clear_internal();
 
     switch (type) {
     case class_type::null:
-        internal_.json_map = nullptr;
+        internal_.value.json_map = nullptr;
         break;
     case class_type::object:
-        internal_.json_map = new map_type{};
+        internal_.value.json_map = allocate_node<map_type>(resource);
         break;
     case class_type::array:
-        internal_.json_list = new list_type{};
+        internal_.value.json_list = allocate_node<list_type>(resource);
         break;
     case class_type::string:
-        internal_.json_string = new string_type{};
-        break;
+        // An empty short string, written through its own layout.
+        internal_.short_string.type = type;
+        internal_.short_string.short_size = 0;
+        return;
     case class_type::floating:
-        internal_.json_float = double{};
+        internal_.value.json_float = double{};
         break;
     case class_type::integral:
-        internal_.json_int = int_type{};
+        internal_.value.json_int = int_type{};
         break;
     case class_type::boolean:
-        internal_.json_bool = false;
+        internal_.value.json_bool = false;
         break;
     }
-    type_ = type;
+    internal_.value.type = type;
 }
 
-void json::clear_internal()
+void json::copy_internal(const json& other)
 {
-    switch (type_) {
+    auto resource = std::pmr::get_default_resource();
+
+    switch (other.internal_.value.type) {
     case class_type::object:
-        delete internal_.json_map;
+        internal_.value.json_map =
+            allocate_node<map_type>(resource, *other.internal_.value.json_map);
         break;
     case class_type::array:
-        delete internal_.json_list;
+        internal_.value.json_list =
+            allocate_node<list_type>(resource, *other.internal_.value.json_list);
         break;
     case class_type::string:
-        delete internal_.json_string;
-        break;
+        if (!other.is_short_string()) {
+            internal_.value.json_string =
+                allocate_node<pmr_string_type>(resource, *other.internal_.value.json_string);
+            internal_.value.short_size = heap_string;
+            break;
+        }
+        [[fallthrough]];
     default:
-        break;
+        // Short strings and scalars are copied whole, in whichever layout they use.
+        internal_ = other.internal_;
+        return;
     }
+    internal_.value.type = other.internal_.value.type;
 }
 
-void json::consume_ws(const string_type& str, size_type& offset)
-{
-    while (isspace(str[offset]))
-        ++offset;
-}
-
-json json::parse_next(const string_type& str, size_type& offset)
+void json::clear_internal()
 {
-    char value;
-    consume_ws(str, offset);
-    value = str[offset];
-
-    switch (value) {
-    case '[':
-        return std::move(parse_array(str, offset));
-    case '{':
-        return std::move(parse_object(str, offset));
-    case '\"':
-        return std::move(parse_string(str, offset));
-    case 't':
-    case 'f':
-        return std::move(parse_bool(str, offset));
-    case 'n':
-        return std::move(parse_null(str, offset));
+    switch (internal_.value.type) {
+    case class_type::object:
+        deallocate_node(internal_.value.json_map);
+        break;
+    case class_type::array:
+        deallocate_node(internal_.value.json_list);
+        break;
+    case class_type::string:
+        if (!is_short_string())
+            deallocate_node(internal_.value.json_string);
+        break;
     default:
-        if (((value <= '9') && (value >= '0')) || (value == '-'))
-            return std::move(parse_number(str, offset));
         break;
     }
-    std::cerr << "ERROR: Parse: Unknown starting character '" << value << "'\n";
-    return {};
 }
 
-json json::parse_object(const string_type& str, size_type& offset)
+void json::assign_string(std::string_view value, std::pmr::memory_resource* resource)
 {
-    auto json_object = json::make(json::class_type::object);
-
-    ++offset;
-    consume_ws(str, offset);
-
-    if (str[offset] == '}') {
-        ++offset;
-        return std::move(json_object);
+    if ((internal_.value.type == class_type::string) && !is_short_string()) {
+        internal_.value.json_string->assign(value);
+        return;
     }
+    set_type(class_type::string);
 
-    while (true) {
-        auto key = parse_next(str, offset);
-        consume_ws(str, offset);
-
-        if (str[offset] != ':') {
-            std::cerr << "Error: Object: Expected colon, found '" << str[offset] << "'\n";
-            break;
-        }
-        consume_ws(str, ++offset);
-        auto value = parse_next(str, offset);
-        json_object[key.to_string()] = value;
-        consume_ws(str, offset);
-
-        if (str[offset] == ',') {
-            ++offset;
-            continue;
-        }
-        else if (str[offset] == '}') {
-            ++offset;
-            break;
-        }
-        else {
-            std::cerr << "ERROR: Object: Expected comma, found '" << str[offset] << "'\n";
-            break;
-        }
+    if (value.size() <= short_string_capacity) {
+        // value may point into this node, when it is a short string already.
+        std::char_traits<char>::move(internal_.short_string.data, value.data(), value.size());
+        internal_.short_string.short_size = static_cast<unsigned char>(value.size());
+    }
+    else {
+        internal_.value.json_string = allocate_node<pmr_string_type>(resource, value);
+        internal_.value.short_size = heap_string;
+        internal_.value.type = class_type::string;
     }
-    return std::move(json_object);
 }
 
-json json::parse_array(const string_type& str, size_type& offset)
+void json::assign_string(pmr_string_type&& value)
 {
-    auto json_array = json::make(json::class_type::array);
-    size_type index{};
-
-    ++offset;
-    consume_ws(str, offset);
-
-    if (str[offset] == ']') {
-        ++offset;
-        return std::move(json_array);
-    }
-
-    while (true) {
-        json_array[index++] = parse_next(str, offset);
-        consume_ws(str, offset);
-
-        if (str[offset] == ',') {
-            ++offset;
-            continue;
-        }
-        else if (str[offset] == ']') {
-            ++offset;
-            break;
-        }
-        else {
-            std::cerr << "ERROR: array: Expected ',' or ']', found '" << str[offset] << "'\n";
-            return std::move(json::make(json::class_type::array));
-        }
-    }
-    return std::move(json_array);
-}
-
-json json::parse_string(const string_type& str, size_type& offset)
-{
-    json json_string;
-    string_type value;
-
-    for (char c = str[++offset]; c != '\"'; c = str[++offset]) {
-        if (c == '\\') {
-            switch (str[++offset]) {
-            case '\"':
-                value += '\"';
-                break;
-            case '\\':
-                value += '\\';
-                break;
-            case '/':
-                value += '/';
-                break;
-            case 'b':
-                value += '\b';
-                break;
-            case 'f':
-                value += '\f';
-                break;
-            case 'n':
-                value += '\n';
-                break;
-            case 'r':
-                value += '\r';
-                break;
-            case 't':
-                value += '\t';
-                break;
-            case 'u':
-            {
-                value += "\\u";
-
-                for (unsigned i = 1; i <= 4; ++i) {
-                    c = str[offset + i];
-
-                    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
-                        (c >= 'A' && c <= 'F')) {
-                        value += c;
-                    }
-                    else {
-                        std::cerr << "ERROR: String: Expected hex character in unicode escape, "
-                                  << "found '" << c << "'\n";
-                        return std::move(json::make(json::class_type::string));
-                    }
-                }
-                offset += 4;
-                break;
-            }
-            default:
-                value += '\\';
-                break;
-            }
-        }
-        else {
-            value += c;
-        }
+    if (value.size() <= short_string_capacity) {
+        assign_string(std::string_view{value});
+        return;
     }
-    ++offset;
-    json_string = value;
-    return std::move(json_string);
+    auto resource = value.get_allocator().resource();
+    set_type(class_type::null);
+    internal_.value.json_string = allocate_node<pmr_string_type>(resource, std::move(value));
+    internal_.value.short_size = heap_string;
+    internal_.value.type = class_type::string;
 }
 
-json json::parse_number(const string_type& str, size_type& offset)
+std::string_view json::string_view() const
 {
-    json number;
-    string_type value;
-    string_type expression_value;
-    char c;
-    bool_type is_floating{};
-    int_type exp{};
-
-    while (true) {
-        c = str[offset++];
-
-        if ((c == '-') || ((c >= '0') && (c <= '9'))) {
-            value += c;
-        }
-        else if (c == '.') {
-            value += c;
-            is_floating = true;
-        }
-        else {
-            break;
-        }
-    }
-
-    if (c == 'E' || c == 'e') {
-        c = str[offset++];
-
-        if (c == '-') {
-            ++offset;
-            expression_value += '-';
-        }
-
-        while (true) {
-            c = str[offset++];
-
-            if (c >= '0' && c <= '9') {
-                expression_value += c;
-            }
-            else if (!isspace(c) && (c != ',') && (c != ']') && (c != '}')) {
-                std::cerr << "ERROR: Number: Expected a number for exponent, found '" << c << "'\n";
-                return std::move(json::make(json::class_type::null));
-            }
-            else {
-                break;
-            }
-        }
-        exp = std::stoll(expression_value);
-    }
-    else if (!isspace(c) && (c != ',') && (c != ']') && (c != '}')) {
-        std::cerr << "ERROR: Number: unexpected character '" << c << "'\n";
-        return std::move(json::make(json::class_type::null));
-    }
-    --offset;
-
-    if (is_floating) {
-        number = std::stod(value) * std::pow(10, exp);
-    }
-    else {
-        number = (!expression_value.empty())
-                     ? static_cast<float_type>(std::stoll(value)) * std::pow(10, exp)
-                     : static_cast<float_type>(std::stoll(value));
-    }
-
-    return std::move(number);
+    return is_short_string()
+               ? std::string_view{internal_.short_string.data, internal_.short_string.short_size}
+               : std::string_view{*internal_.value.json_string};
 }
 
-json json::parse_bool(const string_type& str, size_type& offset)
+bool json::is_short_string() const
 {
-    json json_bool;
-
-    if (str.substr(offset, 4) == "true") {
-        json_bool = true;
-    }
-    else if (str.substr(offset, 5) == "false") {
-        json_bool = false;
-    }
-    else {
-        std::cerr << "ERROR: Bool: Expected 'true' or 'false', found '" << str.substr(offset, 5)
-                  << "'\n";
-
-        return std::move(json::make(json::class_type::null));
-    }
-    offset += json_bool.to_bool() ? 4 : 5;
-    return std::move(json_bool);
+    return internal_.value.short_size != heap_string;
 }
 
-json json::parse_null(const string_type& str, size_type& offset)
+json::string_type json::json_escape(std::string_view value)
 {
-    json json_null;
-
-    if (str.substr(offset, 4) != "null") {
-        std::cerr << "ERROR: Null: Expected 'null', found '" << str.substr(offset, 4) << "'\n";
-        return std::move(json::make(json::class_type::null));
-    }
-    offset += 4;
-    return std::move(json_null);
+    string_type output;
+    json_sink sink{output};
+    json_escape(sink, value);
+    return output;
 }
 
-json::string_type json::json_escape(const string_type& value)
+void json::json_escape(json_sink& sink, std::string_view value)
 {
-    string_type output;
+    while (!value.empty()) {
+        auto run = detail::find_string_special(value.data(), value.size());
+        sink.write(value.data(), run);
 
-    for (const char& i : value) {
-        switch (i) {
+        if (run == value.size())
+            break;
+
+        switch (value[run]) {
         case '\"':
-            output += "\\\"";
+            sink.write("\\\"");
             break;
         case '\\':
-            output += "\\\\";
+            sink.write("\\\\");
             break;
         case '\b':
-            output += "\\b";
+            sink.write("\\b");
             break;
         case '\f':
-            output += "\\f";
+            sink.write("\\f");
             break;
         case '\n':
-            output += "\\n";
+            sink.write("\\n");
             break;
         case '\r':
-            output += "\\r";
+            sink.write("\\r");
             break;
         case '\t':
-            output += "\\t";
+            sink.write("\\t");
             break;
         default:
-            output += i;
+        {
+            // Other control characters have no short escape.
+            constexpr char digits[]{"0123456789abcdef"};
+            const auto c = static_cast<unsigned char>(value[run]);
+            const char escape[]{'\\', 'u', '0', '0', digits[c >> 4], digits[c & 0xf]};
+            sink.write(escape, sizeof(escape));
             break;
         }
+        }
+        value.remove_prefix(run + 1);
     }
-    return std::move(output);
 }
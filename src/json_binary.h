@@ -0,0 +1,163 @@
+#ifndef WINGMANN_JSONLW_JSON_BINARY_H
+#define WINGMANN_JSONLW_JSON_BINARY_H
+
+#include "json.h"
+#include "json_error.h"
+#include "json_sink.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace wingmann::detail {
+
+/// Writes the unsigned integer value in network byte order, as MessagePack and CBOR store it.
+template<typename T>
+void write_big_endian(json_sink& sink, T value)
+{
+    static_assert(std::is_unsigned_v<T>);
+    char bytes[sizeof(T)];
+
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        bytes[i] = static_cast<char>(value >> (8 * (sizeof(T) - 1 - i)));
+    sink.write(bytes, sizeof(T));
+}
+
+template<typename T>
+T read_big_endian(const char* bytes)
+{
+    static_assert(std::is_unsigned_v<T>);
+    T value{};
+
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value = static_cast<T>((value << 8) | static_cast<unsigned char>(bytes[i]));
+    return value;
+}
+
+template<typename To, typename From>
+To bit_cast(From value)
+{
+    static_assert(sizeof(To) == sizeof(From));
+    To result;
+    std::memcpy(&result, &value, sizeof(To));
+    return result;
+}
+
+/// Whether value survives a round trip through single precision, so it can be stored in 4 bytes.
+inline bool fits_float(double value)
+{
+    if (value != value)
+        return true;
+    return (std::fabs(value) <= std::numeric_limits<float>::max()) &&
+           (static_cast<double>(static_cast<float>(value)) == value);
+}
+
+/// Cursor over a binary input, recording the first error like reader does for text.
+class binary_input {
+public:
+    using size_type = std::size_t;
+
+private:
+    std::string_view data_;
+    size_type offset_{};
+    /// Arrays, maps and tags open around the current item.
+    size_type depth_{};
+    json_errc error_{json_errc::none};
+    size_type error_offset_{};
+
+public:
+    explicit binary_input(std::string_view data) : data_{data}
+    {
+    }
+
+    [[nodiscard]] size_type offset() const
+    {
+        return offset_;
+    }
+
+    [[nodiscard]] bool at_end() const
+    {
+        return offset_ == data_.size();
+    }
+
+    /// Takes the next size bytes, or returns null and records unexpected_end.
+    const char* take(size_type size)
+    {
+        if (data_.size() - offset_ < size) {
+            fail(json_errc::unexpected_end, data_.size());
+            return nullptr;
+        }
+        const char* bytes = data_.data() + offset_;
+        offset_ += size;
+        return bytes;
+    }
+
+    /// Reads the next byte without taking it.
+    bool peek(std::uint8_t& value)
+    {
+        if (at_end())
+            return fail(json_errc::unexpected_end, offset_);
+        value = static_cast<std::uint8_t>(data_[offset_]);
+        return true;
+    }
+
+    bool byte(std::uint8_t& value)
+    {
+        const char* bytes = take(1);
+        if (bytes == nullptr)
+            return false;
+        value = static_cast<std::uint8_t>(*bytes);
+        return true;
+    }
+
+    template<typename T>
+    bool big_endian(T& value)
+    {
+        const char* bytes = take(sizeof(T));
+        if (bytes == nullptr)
+            return false;
+        value = read_big_endian<T>(bytes);
+        return true;
+    }
+
+    /// Enters the array, map or tag whose header was just read, failing beyond json::max_depth.
+    bool enter()
+    {
+        return (++depth_ <= json::max_depth) || fail(json_errc::depth_exceeded, offset_);
+    }
+
+    void leave()
+    {
+        --depth_;
+    }
+
+    bool fail(json_errc code, size_type at)
+    {
+        if (error_ == json_errc::none) {
+            error_ = code;
+            error_offset_ = at;
+        }
+        return false;
+    }
+
+    /// Passes on a callback's result, recording a cancellation when it is false.
+    bool emit(bool go_on)
+    {
+        return go_on || fail(json_errc::cancelled, offset_);
+    }
+
+    /// The recorded error, or none; binary input has no lines, so only the offset is set.
+    [[nodiscard]] json_error error() const
+    {
+        return {error_, error_offset_};
+    }
+};
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_BINARY_H
@@ -0,0 +1,188 @@
+#include "json_bind.h"
+#include "json_handler.h"
+#include "json_number.h"
+#include "json_reader.h"
+
+#include <charconv>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+/// Reports parser events to the bound value on top of its stack, through the tables of bind_ops.
+class bind_handler final : public json_handler {
+private:
+    struct frame {
+        detail::bind_target container;
+        /// Field set by the last key of an object.
+        detail::bind_target member;
+        bool is_array;
+    };
+
+    detail::bind_target root_;
+    std::vector<frame> stack_;
+    bool mismatch_{};
+
+public:
+    explicit bind_handler(detail::bind_target root) : root_{root}
+    {
+    }
+
+    [[nodiscard]] bool mismatch() const
+    {
+        return mismatch_;
+    }
+
+    bool on_null() override
+    {
+        auto target = next_target();
+        return check(target.ops->on_null(target.value));
+    }
+
+    bool on_bool(bool value) override
+    {
+        auto target = next_target();
+        return check(target.ops->on_bool(target.value, value));
+    }
+
+    bool on_number(std::int64_t value) override
+    {
+        auto target = next_target();
+        return check(target.ops->on_integer(target.value, value));
+    }
+
+    /// Integers above the range of std::int64_t, which the reader passes here exactly.
+    bool on_unsigned(std::uint64_t value)
+    {
+        auto target = next_target();
+        return check(target.ops->on_unsigned(target.value, value));
+    }
+
+    bool on_number(double value) override
+    {
+        auto target = next_target();
+        return check(target.ops->on_double(target.value, value));
+    }
+
+    bool on_string(std::string_view value) override
+    {
+        auto target = next_target();
+        return check(target.ops->on_string(target.value, value));
+    }
+
+    bool on_start_object() override
+    {
+        auto target = next_target();
+        stack_.push_back({target, {}, false});
+        return check(target.ops->on_start_object(target.value));
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        auto& top = stack_.back();
+        return check(top.container.ops->on_key(top.container.value, key, top.member));
+    }
+
+    bool on_end_object() override
+    {
+        stack_.pop_back();
+        return true;
+    }
+
+    bool on_start_array() override
+    {
+        auto target = next_target();
+        stack_.push_back({target, {}, true});
+        return check(target.ops->on_start_array(target.value));
+    }
+
+    bool on_end_array() override
+    {
+        stack_.pop_back();
+        return true;
+    }
+
+private:
+    bool check(bool ok)
+    {
+        mismatch_ = !ok;
+        return ok;
+    }
+
+    /// The value that the next event is for.
+    detail::bind_target next_target()
+    {
+        if (stack_.empty())
+            return root_;
+
+        auto& top = stack_.back();
+        if (!top.is_array)
+            return top.member;
+
+        detail::bind_target element{nullptr, &detail::skip_ops};
+        if (!top.container.ops->on_element(top.container.value, element))
+            return {nullptr, &detail::reject_ops};
+        return element;
+    }
+};
+
+} // namespace
+
+namespace wingmann::detail {
+
+const bind_ops skip_ops{
+    [](void*) { return true; },
+    [](void*, bool) { return true; },
+    [](void*, std::int64_t) { return true; },
+    [](void*, std::uint64_t) { return true; },
+    [](void*, double) { return true; },
+    [](void*, std::string_view) { return true; },
+    [](void*) { return true; },
+    [](void*, std::string_view, bind_target& member) {
+        member = {nullptr, &skip_ops};
+        return true;
+    },
+    [](void*) { return true; },
+    [](void*, bind_target& element) {
+        element = {nullptr, &skip_ops};
+        return true;
+    }};
+
+void dump_integer(json_sink& sink, std::int64_t value)
+{
+    char buffer[max_number_chars];
+    auto last = format_int(buffer, value);
+    sink.write(buffer, static_cast<std::size_t>(last - buffer));
+}
+
+void dump_unsigned(json_sink& sink, std::uint64_t value)
+{
+    char buffer[max_number_chars];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    sink.write(buffer, static_cast<std::size_t>(result.ptr - buffer));
+}
+
+void dump_double(json_sink& sink, double value)
+{
+    char buffer[max_number_chars];
+    auto last = format_double(buffer, value);
+    sink.write(buffer, static_cast<std::size_t>(last - buffer));
+}
+
+bool parse_bound(std::string_view text, bind_target root, json_error& error)
+{
+    bind_handler handler{root};
+    reader<bind_handler> reader{text, handler};
+
+    if (reader.parse() && reader.finish()) {
+        error = {};
+        return true;
+    }
+
+    auto code = handler.mismatch() ? json_errc::type_mismatch : reader.error();
+    error = locate_error(code, text, reader.error_offset());
+    return false;
+}
+
+} // namespace wingmann::detail
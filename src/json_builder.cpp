@@ -0,0 +1,130 @@
+#include "json_builder.h"
+#include "json_stats_recorder.h"
+
+#include <iterator>
+
+using namespace wingmann;
+
+json_builder::json_builder(std::pmr::memory_resource* resource)
+    : resource_{resource},
+      scratch_{inline_scratch_, sizeof(inline_scratch_), resource},
+      stack_{&scratch_},
+      values_{&scratch_},
+      keys_{&scratch_}
+{
+}
+
+json_builder::json_builder(json_key_pool& keys, std::pmr::memory_resource* resource)
+    : json_builder{resource}
+{
+    key_pool_ = &keys;
+}
+
+json_builder::~json_builder()
+{
+    // Keys of objects left open by a failed parse.
+    for (auto& key : keys_)
+        key.destroy(resource_);
+}
+
+bool json_builder::on_null()
+{
+    next_value(json::class_type::null);
+    return true;
+}
+
+bool json_builder::on_bool(bool value)
+{
+    next_value(json::class_type::boolean) = value;
+    return true;
+}
+
+bool json_builder::on_number(std::int64_t value)
+{
+    next_value(json::class_type::integral) = value;
+    return true;
+}
+
+bool json_builder::on_number(double value)
+{
+    next_value(json::class_type::floating) = value;
+    return true;
+}
+
+bool json_builder::on_string(std::string_view value)
+{
+    next_value(json::class_type::string).assign_string(value, resource_);
+    return true;
+}
+
+bool json_builder::on_start_object()
+{
+    return open();
+}
+
+bool json_builder::on_key(std::string_view key)
+{
+    keys_.push_back((key_pool_ != nullptr) ? key_pool_->intern(key) : json_key{key, resource_});
+    return true;
+}
+
+bool json_builder::on_end_object()
+{
+    detail::stats_timer timer{&json_stats::container_time};
+    const auto top = stack_.back();
+    stack_.pop_back();
+
+    json object;
+    object.set_type(json::class_type::object, resource_);
+
+    auto first_value = values_.begin() + static_cast<std::ptrdiff_t>(top.first_value);
+    auto first_key = keys_.begin() + static_cast<std::ptrdiff_t>(top.first_key);
+    object.internal_.value.json_map->adopt(
+        first_key, std::make_move_iterator(first_value), keys_.size() - top.first_key);
+
+    keys_.erase(first_key, keys_.end());
+    values_.erase(first_value, values_.end());
+    next_value(json::class_type::object) = std::move(object);
+    return true;
+}
+
+bool json_builder::on_start_array()
+{
+    return open();
+}
+
+bool json_builder::on_end_array()
+{
+    detail::stats_timer timer{&json_stats::container_time};
+    const auto top = stack_.back();
+    stack_.pop_back();
+
+    json array;
+    array.set_type(json::class_type::array, resource_);
+
+    auto first = values_.begin() + static_cast<std::ptrdiff_t>(top.first_value);
+    auto& list = *array.internal_.value.json_list;
+    list.reserve(static_cast<size_type>(values_.end() - first));
+    list.insert(list.end(), std::make_move_iterator(first), std::make_move_iterator(values_.end()));
+
+    values_.erase(first, values_.end());
+    next_value(json::class_type::array) = std::move(array);
+    return true;
+}
+
+json& json_builder::result()
+{
+    return root_;
+}
+
+json& json_builder::next_value(json::class_type type)
+{
+    detail::count_node(type, stack_.size() + 1);
+    return stack_.empty() ? root_ : values_.emplace_back();
+}
+
+bool json_builder::open()
+{
+    stack_.push_back(frame{values_.size(), keys_.size()});
+    return true;
+}
@@ -0,0 +1,382 @@
+#include "json.h"
+#include "json_binary.h"
+#include "json_builder.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace wingmann;
+
+namespace {
+
+enum class major_type : std::uint8_t {
+    unsigned_integer = 0,
+    negative_integer = 1,
+    byte_string = 2,
+    text_string = 3,
+    array = 4,
+    map = 5,
+    tag = 6,
+    simple = 7
+};
+
+/// Additional information of an indefinite-length item, and the byte that ends one.
+constexpr std::uint8_t indefinite{31};
+constexpr std::uint8_t break_byte{0xff};
+
+/// Largest integer argument that fits a json integer.
+constexpr auto int_max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+/// Writes the initial byte of an item of type major with argument value, in the fewest bytes.
+void write_cbor_head(json_sink& sink, major_type major, std::uint64_t value)
+{
+    const auto type = static_cast<std::uint8_t>(static_cast<std::uint8_t>(major) << 5);
+
+    if (value < 24) {
+        sink.put(static_cast<char>(type | value));
+    }
+    else if (value <= UINT8_MAX) {
+        sink.put(static_cast<char>(type | 24));
+        sink.put(static_cast<char>(value));
+    }
+    else if (value <= UINT16_MAX) {
+        sink.put(static_cast<char>(type | 25));
+        detail::write_big_endian(sink, static_cast<std::uint16_t>(value));
+    }
+    else if (value <= UINT32_MAX) {
+        sink.put(static_cast<char>(type | 26));
+        detail::write_big_endian(sink, static_cast<std::uint32_t>(value));
+    }
+    else {
+        sink.put(static_cast<char>(type | 27));
+        detail::write_big_endian(sink, value);
+    }
+}
+
+void write_cbor_string(json_sink& sink, std::string_view value)
+{
+    write_cbor_head(sink, major_type::text_string, value.size());
+    sink.write(value);
+}
+
+/// Converts an IEEE 754 half-precision value, which CBOR allows for floats.
+double half_to_double(std::uint16_t half)
+{
+    const int exponent = (half >> 10) & 0x1f;
+    const int mantissa = half & 0x3ff;
+    double value;
+
+    if (exponent == 0)
+        value = std::ldexp(mantissa, -24);
+    else if (exponent != 31)
+        value = std::ldexp(mantissa + 1024, exponent - 25);
+    else
+        value = (mantissa == 0) ? std::numeric_limits<double>::infinity()
+                                : std::numeric_limits<double>::quiet_NaN();
+    return (half & 0x8000) ? -value : value;
+}
+
+/// Decodes one CBOR item and reports it to a handler with the json_handler callbacks.
+template<typename Handler>
+class cbor_reader {
+private:
+    detail::binary_input input_;
+    Handler& handler_;
+    /// Concatenated chunks of an indefinite-length string.
+    std::string scratch_;
+
+public:
+    cbor_reader(std::string_view data, Handler& handler) : input_{data}, handler_{handler}
+    {
+    }
+
+    /// Reads one item, which must span the whole input.
+    bool parse()
+    {
+        if (!parse_item())
+            return false;
+        return input_.at_end() || input_.fail(json_errc::trailing_characters, input_.offset());
+    }
+
+    [[nodiscard]] json_error error() const
+    {
+        return input_.error();
+    }
+
+private:
+    /// Reads the argument that follows an initial byte with additional information info.
+    bool parse_argument(std::uint8_t info, std::size_t start, std::uint64_t& value)
+    {
+        if (info < 24) {
+            value = info;
+            return true;
+        }
+
+        switch (info) {
+        case 24:
+        {
+            std::uint8_t byte;
+            if (!input_.byte(byte))
+                return false;
+            value = byte;
+            return true;
+        }
+        case 25:
+        {
+            std::uint16_t half;
+            if (!input_.big_endian(half))
+                return false;
+            value = half;
+            return true;
+        }
+        case 26:
+        {
+            std::uint32_t word;
+            if (!input_.big_endian(word))
+                return false;
+            value = word;
+            return true;
+        }
+        case 27:
+            return input_.big_endian(value);
+        default:
+            return input_.fail(json_errc::unexpected_character, start);
+        }
+    }
+
+    bool parse_item(bool is_key = false)
+    {
+        const auto start = input_.offset();
+        std::uint8_t initial;
+
+        if (!input_.byte(initial))
+            return false;
+
+        const auto major = static_cast<major_type>(initial >> 5);
+        const auto info = static_cast<std::uint8_t>(initial & 0x1f);
+
+        // Only strings can be keys; tags are skipped first, as they are everywhere.
+        if (is_key && (major != major_type::byte_string) && (major != major_type::text_string) &&
+            (major != major_type::tag))
+            return input_.fail(json_errc::expected_key, start);
+
+        if ((info == indefinite) && (major >= major_type::byte_string) &&
+            (major <= major_type::map))
+            return parse_indefinite(major, is_key);
+        if (major == major_type::simple)
+            return parse_simple(info, start);
+
+        std::uint64_t argument;
+        if (!parse_argument(info, start, argument))
+            return false;
+
+        switch (major) {
+        case major_type::unsigned_integer:
+            if (argument > int_max)
+                return input_.emit(handler_.on_number(static_cast<double>(argument)));
+            return input_.emit(handler_.on_number(static_cast<std::int64_t>(argument)));
+        case major_type::negative_integer:
+            if (argument > int_max)
+                return input_.emit(handler_.on_number(-1.0 - static_cast<double>(argument)));
+            return input_.emit(handler_.on_number(-1 - static_cast<std::int64_t>(argument)));
+        case major_type::byte_string:
+        case major_type::text_string:
+        {
+            // Byte strings have no JSON counterpart and are read as strings.
+            const char* bytes = input_.take(argument);
+            if (bytes == nullptr)
+                return false;
+            return emit_string({bytes, static_cast<std::size_t>(argument)}, is_key);
+        }
+        case major_type::array:
+            if (!input_.enter() || !input_.emit(handler_.on_start_array()))
+                return false;
+            for (std::uint64_t i = 0; i < argument; ++i) {
+                if (!parse_item())
+                    return false;
+            }
+            input_.leave();
+            return input_.emit(handler_.on_end_array());
+        case major_type::map:
+            if (!input_.enter() || !input_.emit(handler_.on_start_object()))
+                return false;
+            for (std::uint64_t i = 0; i < argument; ++i) {
+                if (!parse_item(true) || !parse_item())
+                    return false;
+            }
+            input_.leave();
+            return input_.emit(handler_.on_end_object());
+        default:
+            // Tags only qualify the item that follows, which is read as it is. A run of them
+            // recurses like nested containers, so it is bounded the same way.
+            if (!input_.enter() || !parse_item(is_key))
+                return false;
+            input_.leave();
+            return true;
+        }
+    }
+
+    bool parse_simple(std::uint8_t info, std::size_t start)
+    {
+        switch (info) {
+        case 20:
+            return input_.emit(handler_.on_bool(false));
+        case 21:
+            return input_.emit(handler_.on_bool(true));
+        // Undefined reads as null.
+        case 22:
+        case 23:
+            return input_.emit(handler_.on_null());
+        case 25:
+        {
+            std::uint16_t half;
+            return input_.big_endian(half) && input_.emit(handler_.on_number(half_to_double(half)));
+        }
+        case 26:
+        {
+            std::uint32_t bits;
+            return input_.big_endian(bits) &&
+                   input_.emit(handler_.on_number(
+                       static_cast<double>(detail::bit_cast<float>(bits))));
+        }
+        case 27:
+        {
+            std::uint64_t bits;
+            return input_.big_endian(bits) &&
+                   input_.emit(handler_.on_number(detail::bit_cast<double>(bits)));
+        }
+        default:
+            return input_.fail(json_errc::unexpected_character, start);
+        }
+    }
+
+    /// Reads items up to the break byte, or string chunks that are joined into one string.
+    bool parse_indefinite(major_type major, bool is_key)
+    {
+        if ((major == major_type::byte_string) || (major == major_type::text_string)) {
+            scratch_.clear();
+
+            for (;;) {
+                const auto chunk_start = input_.offset();
+                std::uint8_t initial;
+
+                if (!input_.byte(initial))
+                    return false;
+                if (initial == break_byte)
+                    return emit_string(scratch_, is_key);
+
+                // Chunks are definite strings of the same type.
+                std::uint64_t size;
+                if ((static_cast<major_type>(initial >> 5) != major) ||
+                    !parse_argument(initial & 0x1f, chunk_start, size))
+                    return input_.fail(json_errc::unexpected_character, chunk_start);
+
+                const char* bytes = input_.take(size);
+                if (bytes == nullptr)
+                    return false;
+                scratch_.append(bytes, static_cast<std::size_t>(size));
+            }
+        }
+
+        const bool is_map = major == major_type::map;
+        if (!input_.enter() ||
+            !input_.emit(is_map ? handler_.on_start_object() : handler_.on_start_array()))
+            return false;
+
+        for (;;) {
+            std::uint8_t next;
+            if (!input_.peek(next))
+                return false;
+
+            if (next == break_byte) {
+                input_.take(1);
+                break;
+            }
+            if (!parse_item(is_map) || (is_map && !parse_item()))
+                return false;
+        }
+        input_.leave();
+        return input_.emit(is_map ? handler_.on_end_object() : handler_.on_end_array());
+    }
+
+    bool emit_string(std::string_view value, bool is_key)
+    {
+        return input_.emit(is_key ? handler_.on_key(value) : handler_.on_string(value));
+    }
+};
+
+} // namespace
+
+void json::dump_cbor(json_sink& sink) const
+{
+    switch (internal_.value.type) {
+    case class_type::null:
+        sink.put(static_cast<char>(0xf6));
+        break;
+    case class_type::boolean:
+        sink.put(static_cast<char>(internal_.value.json_bool ? 0xf5 : 0xf4));
+        break;
+    case class_type::integral:
+        if (internal_.value.json_int >= 0)
+            write_cbor_head(sink,
+                            major_type::unsigned_integer,
+                            static_cast<std::uint64_t>(internal_.value.json_int));
+        else
+            write_cbor_head(sink,
+                            major_type::negative_integer,
+                            static_cast<std::uint64_t>(-1 - internal_.value.json_int));
+        break;
+    case class_type::floating:
+        if (detail::fits_float(internal_.value.json_float)) {
+            sink.put(static_cast<char>(0xfa));
+            const auto single = static_cast<float>(internal_.value.json_float);
+            detail::write_big_endian(sink, detail::bit_cast<std::uint32_t>(single));
+        }
+        else {
+            sink.put(static_cast<char>(0xfb));
+            detail::write_big_endian(sink,
+                                     detail::bit_cast<std::uint64_t>(internal_.value.json_float));
+        }
+        break;
+    case class_type::string:
+        write_cbor_string(sink, string_view());
+        break;
+    case class_type::array:
+        write_cbor_head(sink, major_type::array, internal_.value.json_list->size());
+        for (const auto& element : *internal_.value.json_list)
+            element.dump_cbor(sink);
+        break;
+    case class_type::object:
+        write_cbor_head(sink, major_type::map, internal_.value.json_map->size());
+        for (const auto& [name, value] : *internal_.value.json_map) {
+            write_cbor_string(sink, name);
+            value.dump_cbor(sink);
+        }
+        break;
+    }
+}
+
+void json::dump_cbor(string_type& buffer) const
+{
+    json_sink sink{buffer};
+    dump_cbor(sink);
+}
+
+json json::load_cbor(std::string_view data, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load_cbor(data, error, resource));
+}
+
+json json::load_cbor(std::string_view data, json_error& error, std::pmr::memory_resource* resource)
+{
+    json_builder builder{resource};
+    cbor_reader<json_builder> reader{data, builder};
+
+    if (reader.parse()) {
+        error = {};
+        return std::move(builder.result());
+    }
+    error = reader.error();
+    return {};
+}
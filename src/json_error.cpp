@@ -0,0 +1,57 @@
+#include "json_error.h"
+#include "json_reader.h"
+
+#include <algorithm>
+
+using namespace wingmann;
+
+const char* json_error::message() const
+{
+    switch (code) {
+    case json_errc::none:
+        return "no error";
+    case json_errc::unexpected_end:
+        return "unexpected end of input";
+    case json_errc::unexpected_character:
+        return "unexpected character";
+    case json_errc::expected_key:
+        return "expected a string key";
+    case json_errc::expected_colon:
+        return "expected ':' after an object key";
+    case json_errc::expected_comma_or_brace:
+        return "expected ',' or '}' after an object member";
+    case json_errc::expected_comma_or_bracket:
+        return "expected ',' or ']' after an array element";
+    case json_errc::invalid_escape:
+        return "invalid escape sequence";
+    case json_errc::invalid_number:
+        return "invalid number";
+    case json_errc::invalid_literal:
+        return "invalid literal";
+    case json_errc::trailing_characters:
+        return "unexpected data after the value";
+    case json_errc::cancelled:
+        return "cancelled by the handler";
+    case json_errc::io_error:
+        return "cannot read the input";
+    case json_errc::type_mismatch:
+        return "value does not fit the bound type";
+    case json_errc::invalid_snapshot:
+        return "not a valid json snapshot";
+    case json_errc::depth_exceeded:
+        return "values nested too deeply";
+    }
+    return "unknown error";
+}
+
+json_error detail::locate_error(json_errc code, std::string_view input, std::size_t offset)
+{
+    json_error error{code, offset, 1, 1};
+    const auto before = input.substr(0, offset);
+
+    error.line += static_cast<std::size_t>(std::count(before.begin(), before.end(), '\n'));
+
+    const auto line_start = before.rfind('\n');
+    error.column += (line_start == std::string_view::npos) ? offset : offset - line_start - 1;
+    return error;
+}
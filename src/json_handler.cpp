@@ -0,0 +1,151 @@
+#include "json_handler.h"
+#include "json.h"
+#include "json_number.h"
+
+using namespace wingmann;
+
+bool json_handler::on_null()
+{
+    return true;
+}
+
+bool json_handler::on_bool(bool)
+{
+    return true;
+}
+
+bool json_handler::on_number(std::int64_t)
+{
+    return true;
+}
+
+bool json_handler::on_number(double)
+{
+    return true;
+}
+
+bool json_handler::on_string(std::string_view)
+{
+    return true;
+}
+
+bool json_handler::on_start_object()
+{
+    return true;
+}
+
+bool json_handler::on_key(std::string_view)
+{
+    return true;
+}
+
+bool json_handler::on_end_object()
+{
+    return true;
+}
+
+bool json_handler::on_start_array()
+{
+    return true;
+}
+
+bool json_handler::on_end_array()
+{
+    return true;
+}
+
+json_event_writer::json_event_writer(json_sink& sink) : sink_{sink}
+{
+}
+
+bool json_event_writer::on_null()
+{
+    begin_value();
+    sink_.write("null");
+    return true;
+}
+
+bool json_event_writer::on_bool(bool value)
+{
+    begin_value();
+    sink_.write(value ? "true" : "false");
+    return true;
+}
+
+bool json_event_writer::on_number(std::int64_t value)
+{
+    begin_value();
+    char buffer[detail::max_number_chars];
+    sink_.write(buffer, static_cast<std::size_t>(detail::format_int(buffer, value) - buffer));
+    return true;
+}
+
+bool json_event_writer::on_number(double value)
+{
+    begin_value();
+    char buffer[detail::max_number_chars];
+    sink_.write(buffer, static_cast<std::size_t>(detail::format_double(buffer, value) - buffer));
+    return true;
+}
+
+bool json_event_writer::on_string(std::string_view value)
+{
+    begin_value();
+    sink_.put('\"');
+    json::json_escape(sink_, value);
+    sink_.put('\"');
+    return true;
+}
+
+bool json_event_writer::on_start_object()
+{
+    begin_value();
+    sink_.put('{');
+    separate_.push_back(false);
+    return true;
+}
+
+bool json_event_writer::on_key(std::string_view key)
+{
+    begin_value();
+    sink_.put('\"');
+    json::json_escape(sink_, key);
+    sink_.write("\":");
+    after_key_ = true;
+    return true;
+}
+
+bool json_event_writer::on_end_object()
+{
+    sink_.put('}');
+    separate_.pop_back();
+    return true;
+}
+
+bool json_event_writer::on_start_array()
+{
+    begin_value();
+    sink_.put('[');
+    separate_.push_back(false);
+    return true;
+}
+
+bool json_event_writer::on_end_array()
+{
+    sink_.put(']');
+    separate_.pop_back();
+    return true;
+}
+
+void json_event_writer::begin_value()
+{
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (!separate_.empty()) {
+        if (separate_.back())
+            sink_.put(',');
+        separate_.back() = true;
+    }
+}
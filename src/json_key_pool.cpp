@@ -0,0 +1,76 @@
+#include "json_key_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+using namespace wingmann;
+
+namespace {
+
+std::atomic<std::uint64_t> next_pool_id{1};
+
+/// Canonical keys a thread interned lately, at most one per hash slot.
+struct intern_cache {
+    struct entry {
+        std::uint64_t pool{};
+        std::string_view key;
+    };
+
+    static constexpr std::size_t size{256};
+
+    std::array<entry, size> entries{};
+};
+
+thread_local intern_cache recent_keys;
+
+} // namespace
+
+json_key_pool::json_key_pool(std::pmr::memory_resource* upstream)
+    : id_{next_pool_id.fetch_add(1, std::memory_order_relaxed)}, text_{upstream}, keys_{upstream}
+{
+}
+
+json_key json_key_pool::intern(std::string_view key)
+{
+    // Canonical keys stay where they are until the pool is destroyed, and a destroyed pool's id is
+    // never used again, so an entry with this pool's id still points at its key.
+    auto& cached = recent_keys.entries[std::hash<std::string_view>{}(key) % intern_cache::size];
+
+    if ((cached.pool == id_) && (cached.key == key))
+        return json_key{cached.key, json_key::storage::interned};
+
+    auto canonical = find_or_add(key);
+    cached = {id_, canonical};
+    return json_key{canonical, json_key::storage::interned};
+}
+
+json_key_pool::size_type json_key_pool::size() const
+{
+    std::shared_lock lock{mutex_};
+    return keys_.size();
+}
+
+std::string_view json_key_pool::find_or_add(std::string_view key)
+{
+    {
+        std::shared_lock lock{mutex_};
+
+        if (auto i = keys_.find(key); i != keys_.end())
+            return *i;
+    }
+
+    std::unique_lock lock{mutex_};
+
+    // Another thread may have added it since the shared lock was released.
+    if (auto i = keys_.find(key); i != keys_.end())
+        return *i;
+
+    auto* text = static_cast<char*>(text_.allocate(key.size() + 1, 1));
+    std::memcpy(text, key.data(), key.size());
+    text[key.size()] = '\0';
+
+    return *keys_.emplace(text, key.size()).first;
+}
@@ -0,0 +1,202 @@
+#include "json.h"
+#include "json_builder.h"
+#include "json_key_pool.h"
+#include "json_mapped_file.h"
+#include "json_reader.h"
+#include "json_thread_pool.h"
+
+#include <array>
+#include <cctype>
+
+using namespace wingmann;
+
+namespace {
+
+/// Input read per worker before the parsed lines are handed out.
+constexpr std::size_t batch_bytes_per_worker{1024 * 1024};
+
+struct line_span {
+    std::size_t line;
+    std::string_view text;
+};
+
+bool is_blank(std::string_view text)
+{
+    for (char c : text) {
+        if (!isspace(static_cast<unsigned char>(c)))
+            return false;
+    }
+    return true;
+}
+
+json::line_result parse_line(const line_span& span,
+                             json_key_pool* keys,
+                             std::pmr::memory_resource* resource)
+{
+    json_builder builder =
+        (keys != nullptr) ? json_builder{*keys, resource} : json_builder{resource};
+    detail::reader<json_builder> reader{span.text, builder, resource};
+
+    if (!reader.parse()) {
+        return {span.line,
+                {},
+                false,
+                detail::locate_error(reader.error(), span.text, reader.error_offset())};
+    }
+
+    auto rest = span.text.substr(reader.offset());
+    if (!is_blank(rest)) {
+        const auto offset = reader.offset() + rest.find_first_not_of(" \t\n\v\f\r");
+        return {span.line,
+                {},
+                false,
+                detail::locate_error(json_errc::trailing_characters, span.text, offset)};
+    }
+    return {span.line, std::move(builder.result()), true, {}};
+}
+
+/// Lines of one batch, and their results once parsed.
+struct line_batch {
+    std::vector<line_span> spans;
+    std::vector<json::line_result> results;
+};
+
+/// Takes lines off the front of value until about batch_bytes of them are in batch.
+void read_batch(std::string_view& value,
+                std::size_t& line,
+                std::size_t batch_bytes,
+                line_batch& batch)
+{
+    batch.spans.clear();
+
+    for (std::size_t bytes{}; !value.empty() && (bytes < batch_bytes);) {
+        auto end = value.find('\n');
+        auto text = value.substr(0, end);
+
+        value.remove_prefix((end == std::string_view::npos) ? value.size() : end + 1);
+        bytes += text.size() + 1;
+        ++line;
+
+        if (!is_blank(text))
+            batch.spans.push_back({line, text});
+    }
+}
+
+json_thread_pool::job parse_batch(json_thread_pool& pool,
+                                  line_batch& batch,
+                                  json_key_pool* keys,
+                                  std::pmr::memory_resource* resource)
+{
+    batch.results.clear();
+    batch.results.resize(batch.spans.size());
+
+    auto parse = [&batch, keys, resource](std::size_t first, std::size_t last) {
+        for (auto i = first; i < last; ++i)
+            batch.results[i] = parse_line(batch.spans[i], keys, resource);
+    };
+    return pool.start_for(batch.spans.size(), parse);
+}
+
+void load_lines_with(std::string_view value,
+                     json_thread_pool& pool,
+                     json_key_pool* keys,
+                     const std::function<void(json::line_result&)>& callback,
+                     std::pmr::memory_resource* resource)
+{
+    if (value.empty())
+        return;
+
+    const std::size_t batch_bytes = batch_bytes_per_worker * pool.size();
+    std::size_t line{};
+
+    // While the callbacks take the results of one batch, the workers parse the next one.
+    std::array<line_batch, 2> batches;
+    std::size_t current{};
+
+    read_batch(value, line, batch_bytes, batches[current]);
+    auto parsing = parse_batch(pool, batches[current], keys, resource);
+
+    while (true) {
+        parsing.wait();
+
+        auto& ready = batches[current];
+        const bool more = !value.empty();
+
+        if (more) {
+            current ^= 1;
+            read_batch(value, line, batch_bytes, batches[current]);
+            parsing = parse_batch(pool, batches[current], keys, resource);
+        }
+
+        for (auto& result : ready.results)
+            callback(result);
+
+        if (!more)
+            return;
+    }
+}
+
+} // namespace
+
+std::vector<json::line_result> json::load_lines(std::string_view value,
+                                                json_thread_pool& pool,
+                                                std::pmr::memory_resource* resource)
+{
+    std::vector<line_result> results;
+    load_lines_with(
+        value, pool, nullptr,
+        [&results](line_result& result) { results.push_back(std::move(result)); }, resource);
+    return results;
+}
+
+void json::load_lines(std::string_view value,
+                      json_thread_pool& pool,
+                      const std::function<void(line_result&)>& callback,
+                      std::pmr::memory_resource* resource)
+{
+    load_lines_with(value, pool, nullptr, callback, resource);
+}
+
+std::vector<json::line_result> json::load_lines(std::string_view value,
+                                                json_thread_pool& pool,
+                                                json_key_pool& keys,
+                                                std::pmr::memory_resource* resource)
+{
+    std::vector<line_result> results;
+    load_lines_with(
+        value, pool, &keys,
+        [&results](line_result& result) { results.push_back(std::move(result)); }, resource);
+    return results;
+}
+
+void json::load_lines(std::string_view value,
+                      json_thread_pool& pool,
+                      json_key_pool& keys,
+                      const std::function<void(line_result&)>& callback,
+                      std::pmr::memory_resource* resource)
+{
+    load_lines_with(value, pool, &keys, callback, resource);
+}
+
+std::vector<json::line_result> json::load_lines_file(const string_type& path,
+                                                     json_thread_pool& pool,
+                                                     std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return load_lines_file(path, pool, error, resource);
+}
+
+std::vector<json::line_result> json::load_lines_file(const string_type& path,
+                                                     json_thread_pool& pool,
+                                                     json_error& error,
+                                                     std::pmr::memory_resource* resource)
+{
+    detail::mapped_file file{path};
+
+    if (!file.ok()) {
+        error = json_error{json_errc::io_error};
+        return {};
+    }
+    error = {};
+    return load_lines(file.view(), pool, resource);
+}
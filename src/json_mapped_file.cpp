@@ -0,0 +1,122 @@
+#include "json_mapped_file.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace wingmann::detail;
+
+namespace {
+
+constexpr std::size_t read_chunk_size{64 * 1024};
+
+#ifdef _WIN32
+int open_read_only(const std::string& path)
+{
+    return ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+}
+
+long read_some(int fd, char* data, std::size_t size)
+{
+    return ::_read(fd, data, static_cast<unsigned>(size));
+}
+
+void close_file(int fd)
+{
+    ::_close(fd);
+}
+#else
+int open_read_only(const std::string& path)
+{
+    return ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+long read_some(int fd, char* data, std::size_t size)
+{
+    return static_cast<long>(::read(fd, data, size));
+}
+
+void close_file(int fd)
+{
+    ::close(fd);
+}
+#endif
+
+} // namespace
+
+mapped_file::mapped_file(const std::string& path, access_hint hint)
+{
+    int fd = open_read_only(path);
+    if (fd < 0)
+        return;
+
+#ifndef _WIN32
+    struct stat info {};
+
+    if ((::fstat(fd, &info) == 0) && S_ISREG(info.st_mode) && (info.st_size > 0)) {
+        const auto size = static_cast<size_type>(info.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED) {
+            ::madvise(data, size, (hint == access_hint::random) ? MADV_RANDOM : MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(data);
+            size_ = size;
+            mapped_ = true;
+            ok_ = true;
+            close_file(fd);
+            return;
+        }
+    }
+#endif
+
+    (void)hint;
+    ok_ = read_all(fd);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    close_file(fd);
+}
+
+mapped_file::~mapped_file()
+{
+#ifndef _WIN32
+    if (mapped_)
+        ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+std::string_view mapped_file::view() const
+{
+    return {data_, size_};
+}
+
+bool mapped_file::ok() const
+{
+    return ok_;
+}
+
+bool mapped_file::read_all(int fd)
+{
+    while (true) {
+        const auto used = buffer_.size();
+        buffer_.resize(used + read_chunk_size);
+
+        auto count = read_some(fd, buffer_.data() + used, read_chunk_size);
+        if (count < 0) {
+            buffer_.resize(used);
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        buffer_.resize(used + static_cast<size_type>(count));
+        if (count == 0)
+            return true;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef WINGMANN_JSONLW_JSON_MAPPED_FILE_H
+#define WINGMANN_JSONLW_JSON_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace wingmann::detail {
+
+/**
+ * Read-only contents of a file.
+ *
+ * Regular files are memory-mapped. With the sequential hint their pages are read ahead and
+ * can be dropped as soon as they are parsed; with the random hint, used for snapshots, only
+ * the pages that are touched are read. Pipes, character devices and other inputs that cannot
+ * be mapped are read into memory in chunks instead.
+ */
+class mapped_file {
+public:
+    using size_type = std::size_t;
+
+    enum class access_hint { sequential, random };
+
+private:
+    const char* data_{};
+    size_type size_{};
+    bool mapped_{};
+    bool ok_{};
+    std::string buffer_;
+
+public:
+    explicit mapped_file(const std::string& path, access_hint hint = access_hint::sequential);
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file();
+
+    [[nodiscard]] std::string_view view() const;
+
+    /// False when the file could not be opened or read.
+    [[nodiscard]] bool ok() const;
+
+private:
+    bool read_all(int fd);
+};
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_MAPPED_FILE_H
@@ -0,0 +1,349 @@
+#include "json.h"
+#include "json_binary.h"
+#include "json_builder.h"
+
+#include <limits>
+
+using namespace wingmann;
+
+namespace {
+
+/**
+ * Writes the header of a string, array or map of size elements: the fix form when size is below
+ * fix_limit, else the smallest of the sized forms. marker8 is zero for types without one.
+ */
+void write_msgpack_header(json_sink& sink,
+                          std::size_t size,
+                          std::uint8_t fix,
+                          std::uint8_t fix_limit,
+                          std::uint8_t marker8,
+                          std::uint8_t marker16,
+                          std::uint8_t marker32)
+{
+    if (size < fix_limit) {
+        sink.put(static_cast<char>(fix | size));
+    }
+    else if ((marker8 != 0) && (size <= UINT8_MAX)) {
+        sink.put(static_cast<char>(marker8));
+        sink.put(static_cast<char>(size));
+    }
+    else if (size <= UINT16_MAX) {
+        sink.put(static_cast<char>(marker16));
+        detail::write_big_endian(sink, static_cast<std::uint16_t>(size));
+    }
+    else {
+        sink.put(static_cast<char>(marker32));
+        detail::write_big_endian(sink, static_cast<std::uint32_t>(size));
+    }
+}
+
+void write_msgpack_string(json_sink& sink, std::string_view value)
+{
+    write_msgpack_header(sink, value.size(), 0xa0, 32, 0xd9, 0xda, 0xdb);
+    sink.write(value);
+}
+
+void write_msgpack_int(json_sink& sink, std::int64_t value)
+{
+    if ((value >= -32) && (value <= 127)) {
+        sink.put(static_cast<char>(value));
+    }
+    else if (value > 0) {
+        if (value <= UINT8_MAX) {
+            sink.put(static_cast<char>(0xcc));
+            sink.put(static_cast<char>(value));
+        }
+        else if (value <= UINT16_MAX) {
+            sink.put(static_cast<char>(0xcd));
+            detail::write_big_endian(sink, static_cast<std::uint16_t>(value));
+        }
+        else if (value <= UINT32_MAX) {
+            sink.put(static_cast<char>(0xce));
+            detail::write_big_endian(sink, static_cast<std::uint32_t>(value));
+        }
+        else {
+            sink.put(static_cast<char>(0xcf));
+            detail::write_big_endian(sink, static_cast<std::uint64_t>(value));
+        }
+    }
+    else if (value >= INT8_MIN) {
+        sink.put(static_cast<char>(0xd0));
+        sink.put(static_cast<char>(value));
+    }
+    else if (value >= INT16_MIN) {
+        sink.put(static_cast<char>(0xd1));
+        detail::write_big_endian(sink, static_cast<std::uint16_t>(value));
+    }
+    else if (value >= INT32_MIN) {
+        sink.put(static_cast<char>(0xd2));
+        detail::write_big_endian(sink, static_cast<std::uint32_t>(value));
+    }
+    else {
+        sink.put(static_cast<char>(0xd3));
+        detail::write_big_endian(sink, static_cast<std::uint64_t>(value));
+    }
+}
+
+/// Decodes one MessagePack item and reports it to a handler with the json_handler callbacks.
+template<typename Handler>
+class msgpack_reader {
+private:
+    detail::binary_input input_;
+    Handler& handler_;
+
+public:
+    msgpack_reader(std::string_view data, Handler& handler) : input_{data}, handler_{handler}
+    {
+    }
+
+    /// Reads one item, which must span the whole input.
+    bool parse()
+    {
+        if (!parse_item())
+            return false;
+        return input_.at_end() || input_.fail(json_errc::trailing_characters, input_.offset());
+    }
+
+    [[nodiscard]] json_error error() const
+    {
+        return input_.error();
+    }
+
+private:
+    bool parse_item()
+    {
+        const auto start = input_.offset();
+        std::uint8_t marker;
+
+        if (!input_.byte(marker))
+            return false;
+
+        if (marker <= 0x7f)
+            return input_.emit(handler_.on_number(std::int64_t{marker}));
+        if (marker >= 0xe0)
+            return input_.emit(handler_.on_number(std::int64_t{static_cast<std::int8_t>(marker)}));
+        if ((marker & 0xf0) == 0x80)
+            return parse_map(marker & 0x0f);
+        if ((marker & 0xf0) == 0x90)
+            return parse_array(marker & 0x0f);
+        if ((marker & 0xe0) == 0xa0)
+            return parse_string(marker & 0x1f, false);
+
+        switch (marker) {
+        case 0xc0:
+            return input_.emit(handler_.on_null());
+        case 0xc2:
+            return input_.emit(handler_.on_bool(false));
+        case 0xc3:
+            return input_.emit(handler_.on_bool(true));
+        // Binary data has no JSON counterpart and is read as a string.
+        case 0xc4:
+        case 0xd9:
+            return parse_sized<std::uint8_t>(&msgpack_reader::parse_string, false);
+        case 0xc5:
+        case 0xda:
+            return parse_sized<std::uint16_t>(&msgpack_reader::parse_string, false);
+        case 0xc6:
+        case 0xdb:
+            return parse_sized<std::uint32_t>(&msgpack_reader::parse_string, false);
+        case 0xca:
+        {
+            std::uint32_t bits;
+            return input_.big_endian(bits) &&
+                   input_.emit(handler_.on_number(
+                       static_cast<double>(detail::bit_cast<float>(bits))));
+        }
+        case 0xcb:
+        {
+            std::uint64_t bits;
+            return input_.big_endian(bits) &&
+                   input_.emit(handler_.on_number(detail::bit_cast<double>(bits)));
+        }
+        case 0xcc:
+            return parse_integer<std::uint8_t>();
+        case 0xcd:
+            return parse_integer<std::uint16_t>();
+        case 0xce:
+            return parse_integer<std::uint32_t>();
+        case 0xcf:
+            return parse_integer<std::uint64_t>();
+        case 0xd0:
+            return parse_integer<std::uint8_t, std::int8_t>();
+        case 0xd1:
+            return parse_integer<std::uint16_t, std::int16_t>();
+        case 0xd2:
+            return parse_integer<std::uint32_t, std::int32_t>();
+        case 0xd3:
+            return parse_integer<std::uint64_t, std::int64_t>();
+        case 0xdc:
+            return parse_sized<std::uint16_t>(&msgpack_reader::parse_array);
+        case 0xdd:
+            return parse_sized<std::uint32_t>(&msgpack_reader::parse_array);
+        case 0xde:
+            return parse_sized<std::uint16_t>(&msgpack_reader::parse_map);
+        case 0xdf:
+            return parse_sized<std::uint32_t>(&msgpack_reader::parse_map);
+        default:
+            // Extension types and the unused 0xc1.
+            return input_.fail(json_errc::unexpected_character, start);
+        }
+    }
+
+    /// Reads a size of type Size and passes it on to parse.
+    template<typename Size, typename... Args>
+    bool parse_sized(bool (msgpack_reader::*parse)(std::size_t, Args...), Args... args)
+    {
+        Size size;
+        return input_.big_endian(size) && (this->*parse)(size, args...);
+    }
+
+    /// Reads a Bits integer, signed as Signed, which may be wider than the json range.
+    template<typename Bits, typename Signed = void>
+    bool parse_integer()
+    {
+        Bits bits;
+        if (!input_.big_endian(bits))
+            return false;
+
+        if constexpr (!std::is_void_v<Signed>)
+            return input_.emit(handler_.on_number(std::int64_t{static_cast<Signed>(bits)}));
+        else if (bits > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()))
+            return input_.emit(handler_.on_number(static_cast<double>(bits)));
+        else
+            return input_.emit(handler_.on_number(static_cast<std::int64_t>(bits)));
+    }
+
+    bool parse_string(std::size_t size, bool is_key)
+    {
+        const char* bytes = input_.take(size);
+        if (bytes == nullptr)
+            return false;
+
+        std::string_view value{bytes, size};
+        return input_.emit(is_key ? handler_.on_key(value) : handler_.on_string(value));
+    }
+
+    bool parse_array(std::size_t size)
+    {
+        if (!input_.enter() || !input_.emit(handler_.on_start_array()))
+            return false;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!parse_item())
+                return false;
+        }
+        input_.leave();
+        return input_.emit(handler_.on_end_array());
+    }
+
+    bool parse_map(std::size_t size)
+    {
+        if (!input_.enter() || !input_.emit(handler_.on_start_object()))
+            return false;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!parse_key() || !parse_item())
+                return false;
+        }
+        input_.leave();
+        return input_.emit(handler_.on_end_object());
+    }
+
+    /// Keys must be strings, or binary data read as strings.
+    bool parse_key()
+    {
+        const auto start = input_.offset();
+        std::uint8_t marker;
+
+        if (!input_.byte(marker))
+            return false;
+
+        if ((marker & 0xe0) == 0xa0)
+            return parse_string(marker & 0x1f, true);
+
+        switch (marker) {
+        case 0xc4:
+        case 0xd9:
+            return parse_sized<std::uint8_t>(&msgpack_reader::parse_string, true);
+        case 0xc5:
+        case 0xda:
+            return parse_sized<std::uint16_t>(&msgpack_reader::parse_string, true);
+        case 0xc6:
+        case 0xdb:
+            return parse_sized<std::uint32_t>(&msgpack_reader::parse_string, true);
+        default:
+            return input_.fail(json_errc::expected_key, start);
+        }
+    }
+};
+
+} // namespace
+
+void json::dump_msgpack(json_sink& sink) const
+{
+    switch (internal_.value.type) {
+    case class_type::null:
+        sink.put(static_cast<char>(0xc0));
+        break;
+    case class_type::boolean:
+        sink.put(static_cast<char>(internal_.value.json_bool ? 0xc3 : 0xc2));
+        break;
+    case class_type::integral:
+        write_msgpack_int(sink, internal_.value.json_int);
+        break;
+    case class_type::floating:
+        if (detail::fits_float(internal_.value.json_float)) {
+            sink.put(static_cast<char>(0xca));
+            const auto single = static_cast<float>(internal_.value.json_float);
+            detail::write_big_endian(sink, detail::bit_cast<std::uint32_t>(single));
+        }
+        else {
+            sink.put(static_cast<char>(0xcb));
+            detail::write_big_endian(sink,
+                                     detail::bit_cast<std::uint64_t>(internal_.value.json_float));
+        }
+        break;
+    case class_type::string:
+        write_msgpack_string(sink, string_view());
+        break;
+    case class_type::array:
+        write_msgpack_header(sink, internal_.value.json_list->size(), 0x90, 16, 0, 0xdc, 0xdd);
+        for (const auto& element : *internal_.value.json_list)
+            element.dump_msgpack(sink);
+        break;
+    case class_type::object:
+        write_msgpack_header(sink, internal_.value.json_map->size(), 0x80, 16, 0, 0xde, 0xdf);
+        for (const auto& [name, value] : *internal_.value.json_map) {
+            write_msgpack_string(sink, name);
+            value.dump_msgpack(sink);
+        }
+        break;
+    }
+}
+
+void json::dump_msgpack(string_type& buffer) const
+{
+    json_sink sink{buffer};
+    dump_msgpack(sink);
+}
+
+json json::load_msgpack(std::string_view data, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load_msgpack(data, error, resource));
+}
+
+json json::load_msgpack(std::string_view data,
+                        json_error& error,
+                        std::pmr::memory_resource* resource)
+{
+    json_builder builder{resource};
+    msgpack_reader<json_builder> reader{data, builder};
+
+    if (reader.parse()) {
+        error = {};
+        return std::move(builder.result());
+    }
+    error = reader.error();
+    return {};
+}
@@ -0,0 +1,233 @@
+#include "json_number.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace wingmann::detail {
+namespace {
+
+// Every power of ten up to 1e22 is exactly representable as a double.
+constexpr double exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                          1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                          1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+constexpr int max_exact_power{22};
+constexpr std::uint64_t max_exact_mantissa{std::uint64_t{1} << 53};
+constexpr int max_mantissa_digits{19};
+constexpr std::int64_t max_exponent{1'000'000};
+
+bool is_digit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+/**
+ * Correctly rounded conversion for the inputs the fast path cannot handle exactly.
+ * overflow tells which way to saturate when the value is out of the double range.
+ */
+double to_double_slow(const char* first, const char* last, bool overflow)
+{
+    const bool negative = *first == '-';
+    double value{};
+
+#ifdef __cpp_lib_to_chars
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec == std::errc::result_out_of_range) {
+        value = overflow ? std::numeric_limits<double>::infinity() : 0.0;
+        value = negative ? -value : value;
+    }
+#else
+    (void)overflow;
+    const auto size = static_cast<std::size_t>(last - first);
+    char local[64];
+
+    if (size < sizeof(local)) {
+        std::char_traits<char>::copy(local, first, size);
+        local[size] = '\0';
+        value = std::strtod(local, nullptr);
+    }
+    else {
+        value = std::strtod(std::string{first, last}.c_str(), nullptr);
+    }
+#endif
+    return value;
+}
+
+} // namespace
+
+parsed_number parse_number(const char* first, const char* last)
+{
+    parsed_number result{first, false, false, 0, 0.0};
+    const char* p{first};
+
+    const bool negative = (p != last) && (*p == '-');
+    if (negative)
+        ++p;
+
+    if ((p == last) || !is_digit(*p)) {
+        result.end = p;
+        return result;
+    }
+
+    std::uint64_t mantissa{};
+    int digits{};
+    std::int64_t exponent{};
+    bool truncated{};
+    bool is_integral{true};
+
+    if (*p == '0') {
+        ++p;
+    }
+    else {
+        for (; (p != last) && is_digit(*p); ++p) {
+            if (digits < max_mantissa_digits) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                ++digits;
+            }
+            else {
+                ++exponent;
+                truncated = truncated || (*p != '0');
+            }
+        }
+    }
+
+    if ((p != last) && (*p == '.')) {
+        is_integral = false;
+
+        if ((++p == last) || !is_digit(*p)) {
+            result.end = p;
+            return result;
+        }
+        for (; (p != last) && is_digit(*p); ++p) {
+            if (digits < max_mantissa_digits) {
+                // Leading zeros of the fraction only move the exponent.
+                if ((mantissa != 0) || (*p != '0')) {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                    ++digits;
+                }
+                --exponent;
+            }
+            else {
+                truncated = truncated || (*p != '0');
+            }
+        }
+    }
+
+    if ((p != last) && ((*p == 'e') || (*p == 'E'))) {
+        is_integral = false;
+        ++p;
+
+        const bool negative_exponent = (p != last) && (*p == '-');
+        if ((p != last) && ((*p == '-') || (*p == '+')))
+            ++p;
+
+        if ((p == last) || !is_digit(*p)) {
+            result.end = p;
+            return result;
+        }
+
+        std::int64_t value{};
+        for (; (p != last) && is_digit(*p); ++p) {
+            if (value < max_exponent)
+                value = value * 10 + (*p - '0');
+        }
+        exponent += negative_exponent ? -value : value;
+    }
+
+    result.end = p;
+    result.ok = true;
+
+    constexpr auto max_int = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+    if (is_integral && (exponent == 0) && (mantissa <= max_int + (negative ? 1 : 0))) {
+        result.is_integral = true;
+
+        if (!negative)
+            result.integral = static_cast<std::int64_t>(mantissa);
+        else if (mantissa > max_int)
+            result.integral = std::numeric_limits<std::int64_t>::min();
+        else
+            result.integral = -static_cast<std::int64_t>(mantissa);
+        return result;
+    }
+
+    // Clinger's fast path: both the mantissa and the power of ten are exact doubles, so one
+    // correctly rounded multiplication or division gives the correctly rounded result.
+    if (!truncated && (mantissa <= max_exact_mantissa)) {
+        double value{-1.0};
+
+        if (mantissa == 0) {
+            value = 0.0;
+        }
+        else if ((exponent >= -max_exact_power) && (exponent <= max_exact_power)) {
+            value = static_cast<double>(mantissa);
+            value = (exponent < 0) ? value / exact_powers_of_ten[-exponent]
+                                   : value * exact_powers_of_ten[exponent];
+        }
+        else if ((exponent > max_exact_power) && (exponent <= max_exact_power + 15)) {
+            // Move surplus powers of ten into the mantissa while it stays exact.
+            auto scaled = mantissa;
+            auto surplus = exponent - max_exact_power;
+
+            for (; (surplus > 0) && (scaled <= max_exact_mantissa / 10); --surplus)
+                scaled *= 10;
+
+            if (surplus == 0)
+                value = static_cast<double>(scaled) * exact_powers_of_ten[max_exact_power];
+        }
+
+        if (value >= 0.0) {
+            result.floating = negative ? -value : value;
+            return result;
+        }
+    }
+
+    result.floating = to_double_slow(first, p, digits + exponent > 0);
+    return result;
+}
+
+char* format_double(char* first, double value)
+{
+    if (!std::isfinite(value)) {
+        std::char_traits<char>::copy(first, "null", 4);
+        return first + 4;
+    }
+
+#ifdef __cpp_lib_to_chars
+    char* last = std::to_chars(first, first + max_number_chars, value).ptr;
+#else
+    // Without a shortest to_chars, take the first precision that round-trips.
+    int size{};
+    for (int precision = 15; precision <= 17; ++precision) {
+        size = std::snprintf(first, max_number_chars, "%.*g", precision, value);
+        if (std::strtod(first, nullptr) == value)
+            break;
+    }
+    char* last = first + size;
+
+    // snprintf follows the C locale's decimal separator.
+    for (char* p = first; p != last; ++p) {
+        if ((*p != '-') && (*p != '+') && (*p != 'e') && !is_digit(*p))
+            *p = '.';
+    }
+#endif
+
+    for (const char* p = first; p != last; ++p) {
+        if (!is_digit(*p) && (*p != '-'))
+            return last;
+    }
+    *last++ = '.';
+    *last++ = '0';
+    return last;
+}
+
+char* format_int(char* first, std::int64_t value)
+{
+    return std::to_chars(first, first + max_number_chars, value).ptr;
+}
+
+} // namespace wingmann::detail
@@ -0,0 +1,41 @@
+#ifndef WINGMANN_JSONLW_JSON_NUMBER_H
+#define WINGMANN_JSONLW_JSON_NUMBER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wingmann::detail {
+
+struct parsed_number {
+    /// One past the last character of the number, or the offending character on failure.
+    const char* end;
+    bool ok;
+    bool is_integral;
+    std::int64_t integral;
+    double floating;
+};
+
+/**
+ * Parses the JSON number starting at first without allocating.
+ *
+ * Integers that fit std::int64_t are returned as integral, everything else as the double
+ * nearest to the decimal value.
+ */
+parsed_number parse_number(const char* first, const char* last);
+
+/// Buffer size that fits any output of format_double and format_int.
+constexpr std::size_t max_number_chars{32};
+
+/**
+ * Writes the shortest text that reads back as exactly value, independent of the locale,
+ * and returns one past the last character. Integral values keep a trailing ".0" so they
+ * parse back as floating, and non-finite values, which JSON cannot express, become null.
+ */
+char* format_double(char* first, double value);
+
+/// Writes value in decimal and returns one past the last character.
+char* format_int(char* first, std::int64_t value);
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_NUMBER_H
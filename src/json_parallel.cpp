@@ -0,0 +1,145 @@
+#include "json.h"
+#include "json_builder.h"
+#include "json_mapped_file.h"
+#include "json_reader.h"
+#include "json_stats_recorder.h"
+#include "json_structural.h"
+#include "json_thread_pool.h"
+
+#include <cctype>
+#include <memory>
+
+using namespace wingmann;
+
+namespace {
+
+bool is_blank(std::string_view text)
+{
+    for (char c : text) {
+        if (!isspace(static_cast<unsigned char>(c)))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Parses one element of the top-level array, which must be a single value nested one level
+ * deep. On failure returns the error with its offset in text; line and column are left for the
+ * caller, which knows the whole input.
+ */
+json_error parse_element(std::string_view text, json& element, std::pmr::memory_resource* resource)
+{
+    json_builder builder{resource};
+    detail::reader<json_builder> reader{text, builder, resource, 1};
+
+    if (!reader.parse())
+        return {reader.error(), reader.error_offset()};
+
+    auto rest = text.substr(reader.offset());
+    if (!is_blank(rest))
+        return {json_errc::expected_comma_or_bracket,
+                reader.offset() + rest.find_first_not_of(" \t\n\v\f\r")};
+
+    element = std::move(builder.result());
+    return {};
+}
+
+} // namespace
+
+json json::load(std::string_view value, json_thread_pool& pool, std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load(value, pool, error, resource));
+}
+
+json json::load(std::string_view value,
+                json_thread_pool& pool,
+                json_error& error,
+                std::pmr::memory_resource* resource)
+{
+    auto open = value.find_first_not_of(" \t\n\v\f\r");
+
+    if ((value.size() < parallel_load_threshold) || (open == std::string_view::npos) ||
+        (value[open] != '['))
+        return std::move(load(value, error, resource));
+
+    std::vector<size_type> separators;
+
+    // Unclosed or mismatched arrays, empty elements such as a trailing comma, and data after
+    // the array are left to the sequential parser so that they are reported exactly as it
+    // reports them.
+    if (!detail::find_array_elements(value.data(), value.size(), open, separators) ||
+        (value[separators.back()] != ']') || !is_blank(value.substr(separators.back() + 1)))
+        return std::move(load(value, error, resource));
+
+    auto element_first = [&](size_type i) { return ((i == 0) ? open : separators[i - 1]) + 1; };
+    auto element_text = [&](size_type i) {
+        return value.substr(element_first(i), separators[i] - element_first(i));
+    };
+
+    // An empty array has one blank "element" between its brackets.
+    if ((separators.size() == 1) && is_blank(element_text(0))) {
+        error = {};
+        detail::count_node(class_type::array, 1);
+        return std::move(json::make(class_type::array, resource));
+    }
+
+    for (size_type i = 0; i < separators.size(); ++i) {
+        if (is_blank(element_text(i)))
+            return std::move(load(value, error, resource));
+    }
+
+    json array = json::make(class_type::array, resource);
+    auto& list = *array.internal_.value.json_list;
+    list.resize(separators.size());
+
+    auto errors = std::make_unique<json_error[]>(list.size());
+
+    {
+        // The elements are counted one level below the array.
+        detail::stats_nesting nesting{class_type::array};
+
+        pool.parallel_for(list.size(), [&](size_type first, size_type last) {
+            for (auto i = first; i < last; ++i)
+                errors[i] = parse_element(element_text(i), list[i], resource);
+        });
+    }
+
+    // Report the first failed element, as the sequential parser would have stopped there.
+    for (size_type i = 0; i < list.size(); ++i) {
+        if (!errors[i])
+            continue;
+
+        // An element cut short ends at its separator, which the sequential parser would have
+        // read as part of it; let it say what it expected there.
+        if (errors[i].code == json_errc::unexpected_end)
+            return std::move(load(value, error, resource));
+
+        error = detail::locate_error(errors[i].code, value, element_first(i) + errors[i].offset);
+        return {};
+    }
+    error = {};
+    return array;
+}
+
+json json::load_file(const string_type& path,
+                     json_thread_pool& pool,
+                     std::pmr::memory_resource* resource)
+{
+    json_error error;
+    return std::move(load_file(path, pool, error, resource));
+}
+
+json json::load_file(const string_type& path,
+                     json_thread_pool& pool,
+                     json_error& error,
+                     std::pmr::memory_resource* resource)
+{
+    detail::mapped_file file{path};
+
+    if (!file.ok()) {
+        error = json_error{json_errc::io_error};
+        return {};
+    }
+    return std::move(load(file.view(), pool, error, resource));
+}
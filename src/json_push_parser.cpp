@@ -0,0 +1,466 @@
+#include "json_push_parser.h"
+#include "json.h"
+#include "json_number.h"
+#include "json_scan.h"
+
+#include <algorithm>
+#include <cctype>
+
+using namespace wingmann;
+
+namespace {
+
+bool is_space(char c)
+{
+    return isspace(static_cast<unsigned char>(c));
+}
+
+bool is_number_char(char c)
+{
+    return ((c >= '0') && (c <= '9')) || (c == '-') || (c == '+') || (c == '.') || (c == 'e') ||
+           (c == 'E');
+}
+
+} // namespace
+
+json_push_parser::json_push_parser(json_handler& handler) : handler_{handler}
+{
+}
+
+bool json_push_parser::feed(const char* data, size_type size)
+{
+    chunk_ = data;
+    bool ok = parse_chunk(data, size);
+    chunk_ = nullptr;
+
+    // Only the newlines are counted on the way, so error positions cost nothing until needed.
+    std::string_view text{data, size};
+    if (auto last = text.rfind('\n'); last != std::string_view::npos) {
+        lines_ += static_cast<size_type>(std::count(text.begin(), text.end(), '\n'));
+        line_start_ = consumed_ + last + 1;
+    }
+    consumed_ += size;
+    return ok;
+}
+
+bool json_push_parser::parse_chunk(const char* data, size_type size)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p != end) {
+        // States inside a token consume input without skipping whitespace.
+        switch (state_) {
+        case state::done:
+            return true;
+        case state::failed:
+            return false;
+        case state::string:
+            if (!parse_string(p, end))
+                return false;
+            continue;
+        case state::escape:
+            if (!parse_escape(p))
+                return false;
+            continue;
+        case state::unicode:
+            if (!parse_unicode_digit(p))
+                return false;
+            continue;
+        case state::number:
+            if (!parse_number(p, end))
+                return false;
+            continue;
+        case state::literal:
+            if (!parse_literal(p))
+                return false;
+            continue;
+        default:
+            break;
+        }
+
+        char c = *p;
+        if (is_space(c)) {
+            ++p;
+            continue;
+        }
+
+        switch (state_) {
+        case state::first_element_or_end:
+            if (c == ']') {
+                ++p;
+                containers_.pop_back();
+                end_value();
+                if (!emit(handler_.on_end_array()))
+                    return false;
+                break;
+            }
+            state_ = state::value;
+            [[fallthrough]];
+        case state::value:
+            if (!start_value(p))
+                return false;
+            break;
+        case state::first_key_or_end:
+            if (c == '}') {
+                ++p;
+                containers_.pop_back();
+                end_value();
+                if (!emit(handler_.on_end_object()))
+                    return false;
+                break;
+            }
+            [[fallthrough]];
+        case state::key:
+            if (c != '\"')
+                return fail(json_errc::expected_key, offset_of(p));
+            ++p;
+            start_string(true);
+            break;
+        case state::colon:
+            if (c != ':')
+                return fail(json_errc::expected_colon, offset_of(p));
+            ++p;
+            state_ = state::value;
+            break;
+        case state::comma_or_end:
+        {
+            const bool in_object = containers_.back() == '{';
+
+            if (c == ',') {
+                ++p;
+                state_ = in_object ? state::key : state::value;
+            }
+            else if (c == (in_object ? '}' : ']')) {
+                ++p;
+                containers_.pop_back();
+                end_value();
+                if (!emit(in_object ? handler_.on_end_object() : handler_.on_end_array()))
+                    return false;
+            }
+            else if (in_object) {
+                return fail(json_errc::expected_comma_or_brace, offset_of(p));
+            }
+            else {
+                return fail(json_errc::expected_comma_or_bracket, offset_of(p));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return state_ != state::failed;
+}
+
+bool json_push_parser::feed(std::string_view data)
+{
+    return feed(data.data(), data.size());
+}
+
+bool json_push_parser::finish()
+{
+    if ((state_ == state::number) && !end_number(nullptr))
+        return false;
+
+    if (state_ == state::done)
+        return true;
+
+    if (state_ != state::failed)
+        fail(json_errc::unexpected_end, consumed_);
+    return false;
+}
+
+bool json_push_parser::done() const
+{
+    return state_ == state::done;
+}
+
+const json_error& json_push_parser::error() const
+{
+    return error_;
+}
+
+void json_push_parser::reset()
+{
+    // Everything but the handler goes back to its initial value; the buffers keep their capacity.
+    state_ = state::value;
+    containers_.clear();
+    token_.clear();
+    literal_ = nullptr;
+    literal_position_ = 0;
+    unicode_digits_ = 0;
+    unicode_value_ = 0;
+    high_surrogate_ = 0;
+    is_key_ = false;
+    number_start_ = 0;
+    consumed_ = 0;
+    lines_ = 0;
+    line_start_ = 0;
+    chunk_ = nullptr;
+    error_ = {};
+}
+
+json_push_parser::size_type json_push_parser::offset_of(const char* p) const
+{
+    return consumed_ + static_cast<size_type>(p - chunk_);
+}
+
+bool json_push_parser::fail(json_errc code, size_type offset)
+{
+    auto line = lines_ + 1;
+    auto line_start = line_start_;
+
+    // Add the newlines of the current chunk that precede the error.
+    if ((chunk_ != nullptr) && (offset > consumed_)) {
+        std::string_view before{chunk_, offset - consumed_};
+
+        if (auto last = before.rfind('\n'); last != std::string_view::npos) {
+            line += static_cast<size_type>(std::count(before.begin(), before.end(), '\n'));
+            line_start = consumed_ + last + 1;
+        }
+    }
+
+    error_ = {code, offset, line, offset - line_start + 1};
+    state_ = state::failed;
+    return false;
+}
+
+bool json_push_parser::emit(bool go_on)
+{
+    if (!go_on)
+        fail(json_errc::cancelled, consumed_);
+    return go_on;
+}
+
+void json_push_parser::end_value()
+{
+    state_ = containers_.empty() ? state::done : state::comma_or_end;
+}
+
+bool json_push_parser::start_value(const char*& p)
+{
+    char c = *p;
+
+    if (((c == '{') || (c == '[')) && (containers_.size() == json::max_depth))
+        return fail(json_errc::depth_exceeded, offset_of(p));
+
+    switch (c) {
+    case '{':
+        ++p;
+        containers_.push_back('{');
+        state_ = state::first_key_or_end;
+        return emit(handler_.on_start_object());
+    case '[':
+        ++p;
+        containers_.push_back('[');
+        state_ = state::first_element_or_end;
+        return emit(handler_.on_start_array());
+    case '\"':
+        ++p;
+        start_string(false);
+        return true;
+    case 't':
+        literal_ = "true";
+        break;
+    case 'f':
+        literal_ = "false";
+        break;
+    case 'n':
+        literal_ = "null";
+        break;
+    default:
+        if (((c <= '9') && (c >= '0')) || (c == '-')) {
+            // The number state collects the characters, starting with this one.
+            token_.clear();
+            number_start_ = offset_of(p);
+            state_ = state::number;
+            return true;
+        }
+        return fail(json_errc::unexpected_character, offset_of(p));
+    }
+    ++p;
+    literal_position_ = 1;
+    state_ = state::literal;
+    return true;
+}
+
+void json_push_parser::start_string(bool is_key)
+{
+    is_key_ = is_key;
+    token_.clear();
+    state_ = state::string;
+}
+
+bool json_push_parser::end_string(std::string_view value)
+{
+    if (is_key_) {
+        state_ = state::colon;
+        return emit(handler_.on_key(value));
+    }
+    end_value();
+    return emit(handler_.on_string(value));
+}
+
+bool json_push_parser::parse_string(const char*& p, const char* end)
+{
+    const auto available = static_cast<size_type>(end - p);
+    const auto run = detail::find_string_special(p, available);
+
+    // A string that starts and ends within this chunk, without escapes, is passed on in place.
+    if (token_.empty() && (high_surrogate_ == 0) && (run < available) && (p[run] == '\"')) {
+        std::string_view value{p, run};
+        p += run + 1;
+        return end_string(value);
+    }
+
+    // Anything but another escape ends a pending high surrogate.
+    if ((run != 0) || (p[run] != '\\'))
+        end_surrogate();
+
+    token_.append(p, run);
+    p += run;
+
+    if (p == end)
+        return true;
+
+    char c = *p++;
+
+    if (c == '\"')
+        return end_string(token_);
+    if (c != '\\') {
+        // Control characters must be escaped.
+        return fail(json_errc::unexpected_character, offset_of(p - 1));
+    }
+    state_ = state::escape;
+    return true;
+}
+
+bool json_push_parser::parse_escape(const char*& p)
+{
+    const char c = *p;
+
+    state_ = state::string;
+    if (c != 'u')
+        end_surrogate();
+
+    switch (c) {
+    case '\"':
+        token_ += '\"';
+        break;
+    case '\\':
+        token_ += '\\';
+        break;
+    case '/':
+        token_ += '/';
+        break;
+    case 'b':
+        token_ += '\b';
+        break;
+    case 'f':
+        token_ += '\f';
+        break;
+    case 'n':
+        token_ += '\n';
+        break;
+    case 'r':
+        token_ += '\r';
+        break;
+    case 't':
+        token_ += '\t';
+        break;
+    case 'u':
+        unicode_digits_ = 0;
+        unicode_value_ = 0;
+        state_ = state::unicode;
+        break;
+    default:
+        return fail(json_errc::invalid_escape, offset_of(p));
+    }
+    ++p;
+    return true;
+}
+
+bool json_push_parser::parse_unicode_digit(const char*& p)
+{
+    std::uint32_t digit;
+    if (detail::parse_hex4(p, 1, digit) == 0)
+        return fail(json_errc::invalid_escape, offset_of(p));
+
+    ++p;
+    unicode_value_ = unicode_value_ * 16 + digit;
+    if (++unicode_digits_ < 4)
+        return true;
+
+    state_ = state::string;
+
+    if ((high_surrogate_ != 0) && detail::is_low_surrogate(unicode_value_)) {
+        detail::append_utf8(token_, detail::combine_surrogates(high_surrogate_, unicode_value_));
+        high_surrogate_ = 0;
+        return true;
+    }
+
+    end_surrogate();
+    if (detail::is_high_surrogate(unicode_value_))
+        high_surrogate_ = unicode_value_;
+    else if (detail::is_low_surrogate(unicode_value_))
+        detail::append_utf8(token_, detail::replacement_character);
+    else
+        detail::append_utf8(token_, unicode_value_);
+    return true;
+}
+
+void json_push_parser::end_surrogate()
+{
+    if (high_surrogate_ != 0) {
+        detail::append_utf8(token_, detail::replacement_character);
+        high_surrogate_ = 0;
+    }
+}
+
+bool json_push_parser::parse_number(const char*& p, const char* end)
+{
+    while ((p != end) && is_number_char(*p))
+        token_ += *p++;
+
+    // The number may go on in the next chunk.
+    if (p == end)
+        return true;
+    return end_number(p);
+}
+
+bool json_push_parser::end_number(const char* next)
+{
+    const char* first = token_.data();
+    const char* last = first + token_.size();
+    auto number = detail::parse_number(first, last);
+
+    if (!number.ok || (number.end != last)) {
+        // Cut short when the input ends right where the number needs more.
+        const auto code = ((number.end == last) && (next == nullptr)) ? json_errc::unexpected_end
+                                                                      : json_errc::invalid_number;
+        return fail(code, number_start_ + static_cast<size_type>(number.end - first));
+    }
+    if ((next != nullptr) && !is_space(*next) && (*next != ',') && (*next != ']') &&
+        (*next != '}'))
+        return fail(json_errc::invalid_number, offset_of(next));
+
+    end_value();
+    return emit(number.is_integral ? handler_.on_number(number.integral)
+                                   : handler_.on_number(number.floating));
+}
+
+bool json_push_parser::parse_literal(const char*& p)
+{
+    const bool is_null = literal_[0] == 'n';
+
+    if (*p != literal_[literal_position_])
+        return fail(json_errc::invalid_literal, offset_of(p));
+    ++p;
+
+    if (literal_[++literal_position_] != '\0')
+        return true;
+
+    end_value();
+    return emit(is_null ? handler_.on_null() : handler_.on_bool(literal_[0] == 't'));
+}
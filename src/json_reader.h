@@ -0,0 +1,637 @@
+#ifndef WINGMANN_JSONLW_JSON_READER_H
+#define WINGMANN_JSONLW_JSON_READER_H
+
+#include "json.h"
+#include "json_error.h"
+#include "json_number.h"
+#include "json_scan.h"
+#include "json_stats_recorder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace wingmann::detail {
+
+/// Builds the json_error for code at offset, working out its line and column from input.
+json_error locate_error(json_errc code, std::string_view input, std::size_t offset);
+
+/// Whether Handler takes integers above the range of std::int64_t exactly, through on_unsigned.
+template<typename Handler, typename = void>
+struct takes_unsigned : std::false_type {
+};
+
+template<typename Handler>
+struct takes_unsigned<
+    Handler,
+    std::void_t<decltype(std::declval<Handler&>().on_unsigned(std::uint64_t{}))>>
+    : std::true_type {
+};
+
+/**
+ * Recursive-descent JSON grammar that reports what it reads to a handler with the
+ * json_handler callbacks, without building any nodes.
+ *
+ * Handler is json_handler for user handlers, or a final class such as json_builder so the
+ * callbacks are resolved at compile time.
+ */
+template<typename Handler>
+class reader {
+public:
+    using size_type = std::size_t;
+
+private:
+    std::string_view str_;
+    size_type offset_{};
+    Handler& handler_;
+    /// Unescaped text of the current string when it contains escapes.
+    std::pmr::string scratch_;
+    /// Arrays and objects open around the current position.
+    size_type depth_{};
+    json_errc error_{json_errc::none};
+    size_type error_offset_{};
+
+public:
+    /// depth is the number of arrays and objects already open around str, such as the one
+    /// enclosing an element parsed on its own; they count towards json::max_depth.
+    reader(std::string_view str,
+           Handler& handler,
+           std::pmr::memory_resource* resource = std::pmr::get_default_resource(),
+           size_type depth = 0)
+        : str_{str}, handler_{handler}, scratch_{resource}, depth_{depth}
+    {
+    }
+
+    /// Reads one value. Returns false on a syntax error or when the handler stops.
+    bool parse()
+    {
+        return parse_next();
+    }
+
+    /// After parse, checks that only whitespace follows the value.
+    bool finish()
+    {
+        consume_ws();
+        if (offset_ != str_.size())
+            return fail(json_errc::trailing_characters, offset_);
+        return true;
+    }
+
+    /// Reads the string, number or literal that starts at offset, which the caller has located.
+    bool parse_token_at(size_type offset, bool is_key)
+    {
+        offset_ = offset;
+
+        switch (peek()) {
+        case '\"':
+            return parse_string(is_key);
+        case 't':
+        case 'f':
+            return parse_bool();
+        case 'n':
+            return parse_null();
+        default:
+            return parse_number();
+        }
+    }
+
+    [[nodiscard]] size_type offset() const
+    {
+        return offset_;
+    }
+
+    /// Why parse returned false, or none.
+    [[nodiscard]] json_errc error() const
+    {
+        return error_;
+    }
+
+    [[nodiscard]] size_type error_offset() const
+    {
+        return error_offset_;
+    }
+
+private:
+    /// Records the first error. Any error at the end of the input means the input was cut short.
+    bool fail(json_errc code, size_type at)
+    {
+        error_ = (at >= str_.size()) ? json_errc::unexpected_end : code;
+        error_offset_ = std::min(at, str_.size());
+        return false;
+    }
+
+    /// Passes on a callback's result, recording a cancellation when it is false.
+    bool emit(bool go_on)
+    {
+        if (!go_on) {
+            error_ = json_errc::cancelled;
+            error_offset_ = offset_;
+        }
+        return go_on;
+    }
+
+    /// Enters an array or object, failing beyond json::max_depth.
+    bool open_container()
+    {
+        if (++depth_ > json::max_depth)
+            return fail(json_errc::depth_exceeded, offset_);
+        return true;
+    }
+
+    /// Leaves the innermost array or object, passing on the result of its end callback.
+    bool close_container(bool go_on)
+    {
+        --depth_;
+        return emit(go_on);
+    }
+
+    /// The character at offset, or '\0' past the end of the input.
+    [[nodiscard]] char peek() const
+    {
+        return (offset_ < str_.size()) ? str_[offset_] : '\0';
+    }
+
+    void consume_ws()
+    {
+        while ((offset_ < str_.size()) && isspace(static_cast<unsigned char>(str_[offset_])))
+            ++offset_;
+    }
+
+    bool parse_next()
+    {
+        consume_ws();
+        char value = peek();
+
+        switch (value) {
+        case '[':
+            return parse_array();
+        case '{':
+            return parse_object();
+        case '\"':
+            return parse_string(false);
+        case 't':
+        case 'f':
+            return parse_bool();
+        case 'n':
+            return parse_null();
+        default:
+            if (((value <= '9') && (value >= '0')) || (value == '-'))
+                return parse_number();
+            break;
+        }
+        return fail(json_errc::unexpected_character, offset_);
+    }
+
+    bool parse_object()
+    {
+        if (!open_container() || !emit(handler_.on_start_object()))
+            return false;
+
+        ++offset_;
+        consume_ws();
+
+        if (peek() == '}') {
+            ++offset_;
+            return close_container(handler_.on_end_object());
+        }
+
+        while (true) {
+            if (peek() != '\"')
+                return fail(json_errc::expected_key, offset_);
+            if (!parse_string(true))
+                return false;
+
+            consume_ws();
+            if (peek() != ':')
+                return fail(json_errc::expected_colon, offset_);
+
+            ++offset_;
+            if (!parse_next())
+                return false;
+            consume_ws();
+
+            if (peek() == ',') {
+                ++offset_;
+                consume_ws();
+                continue;
+            }
+            else if (peek() == '}') {
+                ++offset_;
+                return close_container(handler_.on_end_object());
+            }
+            else {
+                return fail(json_errc::expected_comma_or_brace, offset_);
+            }
+        }
+    }
+
+    bool parse_array()
+    {
+        if (!open_container() || !emit(handler_.on_start_array()))
+            return false;
+
+        ++offset_;
+        consume_ws();
+
+        if (peek() == ']') {
+            ++offset_;
+            return close_container(handler_.on_end_array());
+        }
+
+        while (true) {
+            if (!parse_next())
+                return false;
+            consume_ws();
+
+            if (peek() == ',') {
+                ++offset_;
+                continue;
+            }
+            else if (peek() == ']') {
+                ++offset_;
+                return close_container(handler_.on_end_array());
+            }
+            else {
+                return fail(json_errc::expected_comma_or_bracket, offset_);
+            }
+        }
+    }
+
+    bool emit_string(std::string_view value, bool is_key)
+    {
+        return emit(is_key ? handler_.on_key(value) : handler_.on_string(value));
+    }
+
+    bool parse_string(bool is_key)
+    {
+        stats_timer timer{&json_stats::string_time};
+        ++offset_;
+
+        // Strings without escapes, the common case, are passed on straight from the input.
+        auto end = offset_ + find_string_special(str_.data() + offset_, str_.size() - offset_);
+        if ((end < str_.size()) && (str_[end] == '\"')) {
+            auto value = str_.substr(offset_, end - offset_);
+            offset_ = end + 1;
+            return emit_string(value, is_key);
+        }
+
+        scratch_.clear();
+
+        for (; offset_ < str_.size(); ++offset_) {
+            // Copy the run of plain characters up to the next quote, backslash or control byte.
+            auto run = find_string_special(str_.data() + offset_, str_.size() - offset_);
+            scratch_.append(str_.data() + offset_, run);
+            offset_ += run;
+
+            if (offset_ == str_.size())
+                break;
+
+            char c = str_[offset_];
+
+            if (c == '\"') {
+                ++offset_;
+                return emit_string(scratch_, is_key);
+            }
+            else if (c == '\\') {
+                ++offset_;
+
+                switch (peek()) {
+                case '\"':
+                    scratch_ += '\"';
+                    break;
+                case '\\':
+                    scratch_ += '\\';
+                    break;
+                case '/':
+                    scratch_ += '/';
+                    break;
+                case 'b':
+                    scratch_ += '\b';
+                    break;
+                case 'f':
+                    scratch_ += '\f';
+                    break;
+                case 'n':
+                    scratch_ += '\n';
+                    break;
+                case 'r':
+                    scratch_ += '\r';
+                    break;
+                case 't':
+                    scratch_ += '\t';
+                    break;
+                case 'u':
+                    if (!parse_unicode_escape())
+                        return false;
+                    break;
+                default:
+                    return fail(json_errc::invalid_escape, offset_);
+                }
+            }
+            else {
+                // Control characters must be escaped.
+                return fail(json_errc::unexpected_character, offset_);
+            }
+        }
+        return fail(json_errc::unexpected_end, str_.size());
+    }
+
+    /// Decodes the \u escape whose 'u' is at offset, and a low surrogate escape right after it.
+    bool parse_unicode_escape()
+    {
+        std::uint32_t code;
+        auto digits = parse_hex4(str_.data() + offset_ + 1, str_.size() - offset_ - 1, code);
+        if (digits != 4)
+            return fail(json_errc::invalid_escape, offset_ + 1 + digits);
+        offset_ += 4;
+
+        if (is_high_surrogate(code)) {
+            // The low half must follow as another escape; if it does not, the next iteration
+            // reads whatever follows.
+            const auto next = offset_ + 1;
+            std::uint32_t low{};
+
+            if ((str_.size() - next >= 2) && (str_[next] == '\\') && (str_[next + 1] == 'u') &&
+                (parse_hex4(str_.data() + next + 2, str_.size() - next - 2, low) == 4) &&
+                is_low_surrogate(low)) {
+                code = combine_surrogates(code, low);
+                offset_ += 6;
+            }
+        }
+
+        append_utf8(scratch_,
+                    (is_high_surrogate(code) || is_low_surrogate(code)) ? replacement_character
+                                                                       : code);
+        return true;
+    }
+
+    bool parse_number()
+    {
+        stats_timer timer{&json_stats::number_time};
+        const char* first = str_.data() + offset_;
+        const char* last = str_.data() + str_.size();
+        auto number = detail::parse_number(first, last);
+        char c = (number.end != last) ? *number.end : '\0';
+
+        if (!number.ok ||
+            ((number.end != last) && !isspace(static_cast<unsigned char>(c)) && (c != ',') &&
+             (c != ']') && (c != '}'))) {
+            return fail(json_errc::invalid_number,
+                        static_cast<size_type>(number.end - str_.data()));
+        }
+        offset_ += static_cast<size_type>(number.end - first);
+
+        if constexpr (takes_unsigned<Handler>::value) {
+            // parse_number reads integers beyond std::int64_t as floating, losing their digits.
+            if (!number.is_integral) {
+                std::uint64_t value{};
+                auto [end, error] = std::from_chars(first, number.end, value);
+
+                if ((error == std::errc{}) && (end == number.end))
+                    return emit(handler_.on_unsigned(value));
+            }
+        }
+        return emit(number.is_integral ? handler_.on_number(number.integral)
+                                       : handler_.on_number(number.floating));
+    }
+
+    bool parse_bool()
+    {
+        const bool value = peek() == 't';
+
+        if (!match_literal(value ? "true" : "false"))
+            return false;
+        return emit(handler_.on_bool(value));
+    }
+
+    bool parse_null()
+    {
+        if (!match_literal("null"))
+            return false;
+        return emit(handler_.on_null());
+    }
+
+    bool match_literal(std::string_view word)
+    {
+        size_type i{};
+
+        while ((i < word.size()) && (offset_ + i < str_.size()) && (str_[offset_ + i] == word[i]))
+            ++i;
+
+        if (i != word.size())
+            return fail(json_errc::invalid_literal, offset_ + i);
+
+        offset_ += i;
+        return true;
+    }
+};
+
+/**
+ * Stage two of the structural-index parser: follows the token positions found by
+ * build_structural_index instead of scanning the input, and reports to a handler like reader.
+ * Tokens themselves are read with reader.
+ */
+template<typename Handler>
+class indexed_reader {
+public:
+    using size_type = std::size_t;
+
+private:
+    std::string_view str_;
+    const std::vector<std::uint32_t>& index_;
+    size_type next_{};
+    size_type position_{};
+    Handler& handler_;
+    reader<Handler> tokens_;
+    /// Arrays and objects open around the current token.
+    size_type depth_{};
+    json_errc error_{json_errc::none};
+    size_type error_offset_{};
+
+public:
+    indexed_reader(std::string_view str,
+                   const std::vector<std::uint32_t>& index,
+                   Handler& handler,
+                   std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : str_{str}, index_{index}, handler_{handler}, tokens_{str, handler, resource}
+    {
+    }
+
+    bool parse()
+    {
+        return parse_value(advance(), json_errc::none);
+    }
+
+    /// After parse, checks that no token follows the value.
+    bool finish()
+    {
+        if (next_ != index_.size())
+            return fail(json_errc::trailing_characters, index_[next_]);
+        return true;
+    }
+
+    [[nodiscard]] json_errc error() const
+    {
+        return (error_ != json_errc::none) ? error_ : tokens_.error();
+    }
+
+    [[nodiscard]] size_type error_offset() const
+    {
+        return (error_ != json_errc::none) ? error_offset_ : tokens_.error_offset();
+    }
+
+private:
+    bool fail(json_errc code, size_type at)
+    {
+        error_ = (at >= str_.size()) ? json_errc::unexpected_end : code;
+        error_offset_ = std::min(at, str_.size());
+        return false;
+    }
+
+    bool emit(bool go_on)
+    {
+        if (!go_on) {
+            error_ = json_errc::cancelled;
+            error_offset_ = position_;
+        }
+        return go_on;
+    }
+
+    bool open_container()
+    {
+        if (++depth_ > json::max_depth)
+            return fail(json_errc::depth_exceeded, position_);
+        return true;
+    }
+
+    bool close_container(bool go_on)
+    {
+        --depth_;
+        return emit(go_on);
+    }
+
+    /// Moves to the next token and returns its first character, or '\0' after the last one.
+    char advance()
+    {
+        if (next_ == index_.size()) {
+            position_ = str_.size();
+            return '\0';
+        }
+        position_ = index_[next_++];
+        return str_[position_];
+    }
+
+    /// after is reported when a literal runs into more text, or none to accept that as reader does.
+    bool parse_value(char c, json_errc after)
+    {
+        switch (c) {
+        case '[':
+            return parse_array();
+        case '{':
+            return parse_object();
+        case '\"':
+            return tokens_.parse_token_at(position_, false);
+        case 't':
+        case 'f':
+        case 'n':
+            return parse_literal(after);
+        default:
+            if (((c <= '9') && (c >= '0')) || (c == '-'))
+                return tokens_.parse_token_at(position_, false);
+            break;
+        }
+        return fail(json_errc::unexpected_character, position_);
+    }
+
+    bool parse_literal(json_errc after)
+    {
+        if (!tokens_.parse_token_at(position_, false))
+            return false;
+
+        // Literals are not split from what follows them, so "truex" is one token.
+        auto end = tokens_.offset();
+        char c = (end < str_.size()) ? str_[end] : '\0';
+
+        if ((c != '\0') && !isspace(static_cast<unsigned char>(c)) && (c != ',') && (c != ']') &&
+            (c != '}') && (after != json_errc::none)) {
+            return fail(after, end);
+        }
+        return true;
+    }
+
+    bool parse_object()
+    {
+        if (!open_container() || !emit(handler_.on_start_object()))
+            return false;
+
+        char c = advance();
+        if (c == '}')
+            return close_container(handler_.on_end_object());
+
+        while (true) {
+            if (c != '\"')
+                return fail(json_errc::expected_key, position_);
+            if (!tokens_.parse_token_at(position_, true))
+                return false;
+
+            c = advance();
+            if (c != ':')
+                return fail(json_errc::expected_colon, position_);
+
+            if (!parse_value(advance(), json_errc::expected_comma_or_brace))
+                return false;
+
+            c = advance();
+            if (c == ',') {
+                c = advance();
+                continue;
+            }
+            else if (c == '}') {
+                return close_container(handler_.on_end_object());
+            }
+            else {
+                return fail(json_errc::expected_comma_or_brace, position_);
+            }
+        }
+    }
+
+    bool parse_array()
+    {
+        if (!open_container() || !emit(handler_.on_start_array()))
+            return false;
+
+        char c = advance();
+        if (c == ']')
+            return close_container(handler_.on_end_array());
+
+        while (true) {
+            if (!parse_value(c, json_errc::expected_comma_or_bracket))
+                return false;
+
+            c = advance();
+            if (c == ',') {
+                c = advance();
+                continue;
+            }
+            else if (c == ']') {
+                return close_container(handler_.on_end_array());
+            }
+            else {
+                return fail(json_errc::expected_comma_or_bracket, position_);
+            }
+        }
+    }
+};
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_READER_H
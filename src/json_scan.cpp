@@ -0,0 +1,120 @@
+#include "json_scan.h"
+#include "json_simd.h"
+
+namespace wingmann::detail {
+namespace {
+
+using kernel_type = std::size_t (*)(const char*, std::size_t);
+
+bool is_special(char c)
+{
+    return (c == '\"') || (c == '\\') || (static_cast<unsigned char>(c) < 0x20);
+}
+
+std::size_t find_scalar(const char* data, std::size_t size)
+{
+    std::size_t i{};
+    while (i < size && !is_special(data[i]))
+        ++i;
+    return i;
+}
+
+#ifdef WINGMANN_JSONLW_X86_SIMD
+
+unsigned count_trailing_zeros(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+std::size_t find_sse2(const char* data, std::size_t size)
+{
+    const auto quote = _mm_set1_epi8('\"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control = _mm_set1_epi8(0x1F);
+    std::size_t i{};
+
+    for (; i + 16 <= size; i += 16) {
+        auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Unsigned chunk <= 0x1F, as there is no unsigned byte compare in SSE2.
+        auto hits = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control);
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, quote));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, backslash));
+
+        if (auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits)))
+            return i + count_trailing_zeros(mask);
+    }
+    return i + find_scalar(data + i, size - i);
+}
+
+WINGMANN_JSONLW_TARGET_AVX2 std::size_t find_avx2(const char* data, std::size_t size)
+{
+    const auto quote = _mm256_set1_epi8('\"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto control = _mm256_set1_epi8(0x1F);
+    std::size_t i{};
+
+    for (; i + 32 <= size; i += 32) {
+        auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        auto hits = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control), control);
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, quote));
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, backslash));
+
+        if (auto mask = static_cast<unsigned>(_mm256_movemask_epi8(hits)))
+            return i + count_trailing_zeros(mask);
+    }
+    // Clear the upper halves before the SSE2 code, which would otherwise pay for a state
+    // transition on every short string.
+    _mm256_zeroupper();
+    return i + find_sse2(data + i, size - i);
+}
+
+#endif
+
+kernel_type select_kernel()
+{
+#ifdef WINGMANN_JSONLW_X86_SIMD
+    return cpu_has_avx2() ? find_avx2 : find_sse2;
+#else
+    return find_scalar;
+#endif
+}
+
+} // namespace
+
+std::size_t find_string_special(const char* data, std::size_t size)
+{
+    // Keys and other short strings are done before a vector kernel would have set up.
+    if (size < 16)
+        return find_scalar(data, size);
+
+    static const kernel_type kernel = select_kernel();
+    return kernel(data, size);
+}
+
+#ifdef WINGMANN_JSONLW_X86_SIMD
+bool cpu_has_avx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    const bool os_saves_ymm = (info[2] & (1 << 27)) && ((_xgetbv(0) & 0x6) == 0x6);
+
+    __cpuidex(info, 7, 0);
+    return os_saves_ymm && (info[1] & (1 << 5));
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+} // namespace wingmann::detail
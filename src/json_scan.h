@@ -0,0 +1,87 @@
+#ifndef WINGMANN_JSONLW_JSON_SCAN_H
+#define WINGMANN_JSONLW_JSON_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wingmann::detail {
+
+/**
+ * Returns the index of the first quote, backslash or control character (below 0x20)
+ * in [data, data + size), or size if there is none.
+ *
+ * Scans 32 bytes at a time with AVX2 or 16 with SSE2, whichever the CPU supports,
+ * and one byte at a time elsewhere.
+ */
+std::size_t find_string_special(const char* data, std::size_t size);
+
+/// Written in place of a \u escape of an unpaired surrogate.
+constexpr std::uint32_t replacement_character{0xfffd};
+
+/**
+ * Reads the four hex digits of a \u escape from [data, data + size) into value.
+ * Returns how many leading characters are hex digits, four on success.
+ */
+inline std::size_t parse_hex4(const char* data, std::size_t size, std::uint32_t& value)
+{
+    value = 0;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        const char c = (i < size) ? data[i] : '\0';
+        std::uint32_t digit;
+
+        if (c >= '0' && c <= '9')
+            digit = static_cast<std::uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f')
+            digit = static_cast<std::uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F')
+            digit = static_cast<std::uint32_t>(c - 'A' + 10);
+        else
+            return i;
+        value = value * 16 + digit;
+    }
+    return 4;
+}
+
+inline bool is_high_surrogate(std::uint32_t code)
+{
+    return (code >= 0xd800) && (code <= 0xdbff);
+}
+
+inline bool is_low_surrogate(std::uint32_t code)
+{
+    return (code >= 0xdc00) && (code <= 0xdfff);
+}
+
+inline std::uint32_t combine_surrogates(std::uint32_t high, std::uint32_t low)
+{
+    return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+}
+
+/// Appends code, which must not be a surrogate, to output as UTF-8.
+template<typename String>
+void append_utf8(String& output, std::uint32_t code)
+{
+    if (code < 0x80) {
+        output += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        output += static_cast<char>(0xc0 | (code >> 6));
+        output += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else if (code < 0x10000) {
+        output += static_cast<char>(0xe0 | (code >> 12));
+        output += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else {
+        output += static_cast<char>(0xf0 | (code >> 18));
+        output += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        output += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_SCAN_H
@@ -0,0 +1,27 @@
+#ifndef WINGMANN_JSONLW_JSON_SIMD_H
+#define WINGMANN_JSONLW_JSON_SIMD_H
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#define WINGMANN_JSONLW_X86_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define WINGMANN_JSONLW_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WINGMANN_JSONLW_TARGET_AVX2
+#endif
+
+namespace wingmann::detail {
+
+#ifdef WINGMANN_JSONLW_X86_SIMD
+/// Whether the CPU and the operating system support AVX2.
+bool cpu_has_avx2();
+#endif
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_SIMD_H
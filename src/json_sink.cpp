@@ -0,0 +1,68 @@
+#include "json_sink.h"
+
+#include <cerrno>
+#include <ostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace wingmann;
+
+json_sink::json_sink(std::string& buffer) : buffer_{&buffer}
+{
+}
+
+json_sink::json_sink(std::ostream& stream, size_type buffer_size)
+    : buffer_{&local_}, stream_{&stream}, flush_threshold_{buffer_size}
+{
+    local_.reserve(buffer_size);
+}
+
+json_sink::json_sink(int fd, size_type buffer_size)
+    : buffer_{&local_}, fd_{fd}, flush_threshold_{buffer_size}
+{
+    local_.reserve(buffer_size);
+}
+
+json_sink::~json_sink()
+{
+    flush();
+}
+
+void json_sink::flush()
+{
+    if (buffer_ != &local_ || local_.empty())
+        return;
+
+    if (stream_) {
+        good_ = good_ && stream_->write(local_.data(), static_cast<std::streamsize>(local_.size()));
+    }
+    else {
+        const char* data = local_.data();
+        size_type left = local_.size();
+
+        while (good_ && left > 0) {
+#ifdef _WIN32
+            auto written = ::_write(fd_, data, static_cast<unsigned>(left));
+#else
+            auto written = ::write(fd_, data, left);
+#endif
+            // Retry an interrupted write; a write that makes no progress would never finish.
+            if (written <= 0) {
+                good_ = (written < 0) && (errno == EINTR);
+                continue;
+            }
+            data += written;
+            left -= static_cast<size_type>(written);
+        }
+    }
+    local_.clear();
+}
+
+bool json_sink::good() const
+{
+    return good_;
+}
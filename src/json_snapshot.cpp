@@ -0,0 +1,524 @@
+#include "json_view.h"
+#include "json_mapped_file.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+/**
+ * Layout of a value in a snapshot. Scalars are stored in payload, and so are strings of up to
+ * eight bytes; longer strings, array elements and object members are stored elsewhere in the
+ * snapshot, at offset payload from its start, and size counts their bytes or slots.
+ *
+ * The members of an object are pairs of slots, a string for the key followed by the value.
+ * Objects with more than json::map_type::linear_search_limit members are followed by the
+ * indexes of their members sorted by key, as 32-bit numbers.
+ */
+struct snapshot_slot {
+    std::uint8_t type;
+    std::uint8_t reserved[3];
+    std::uint32_t size;
+    std::uint64_t payload;
+};
+
+static_assert(sizeof(snapshot_slot) == json_view::slot_size, "snapshot slot layout changed");
+
+struct snapshot_header {
+    std::uint32_t magic;
+    std::uint32_t version;
+    /// Bytes in the snapshot, header included.
+    std::uint64_t size;
+};
+
+/// "JLWS" in the byte order of the writer, so that other byte orders fail the check.
+constexpr std::uint32_t snapshot_magic{0x534c574a};
+constexpr std::uint32_t snapshot_version{1};
+
+constexpr std::size_t root_offset{sizeof(snapshot_header)};
+constexpr std::size_t inline_text_capacity{sizeof(snapshot_slot::payload)};
+constexpr std::size_t index_entry_size{sizeof(std::uint32_t)};
+
+std::uint32_t checked_size(std::size_t size)
+{
+    if (size > std::numeric_limits<std::uint32_t>::max())
+        throw std::length_error{"json::dump_snapshot: value too large for a snapshot"};
+    return static_cast<std::uint32_t>(size);
+}
+
+/// Appends size zero bytes at an offset aligned to eight and returns it, relative to start.
+std::size_t reserve_bytes(std::string& buffer, std::size_t start, std::size_t size)
+{
+    const auto at = (buffer.size() - start + 7) & ~std::size_t{7};
+    buffer.resize(start + at + size);
+    return at;
+}
+
+void store_slot(std::string& buffer, std::size_t start, std::size_t at, const snapshot_slot& slot)
+{
+    std::memcpy(buffer.data() + start + at, &slot, sizeof(slot));
+}
+
+snapshot_slot text_slot(std::string& buffer, std::size_t start, std::string_view text)
+{
+    snapshot_slot slot{};
+    slot.type = static_cast<std::uint8_t>(json::class_type::string);
+    slot.size = checked_size(text.size());
+
+    if (text.size() <= inline_text_capacity) {
+        std::memcpy(&slot.payload, text.data(), text.size());
+    }
+    else {
+        slot.payload = buffer.size() - start;
+        buffer.append(text);
+    }
+    return slot;
+}
+
+snapshot_slot read_slot(const char* data)
+{
+    snapshot_slot slot;
+    std::memcpy(&slot, data, sizeof(slot));
+    return slot;
+}
+
+std::uint32_t read_index(const char* data)
+{
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+bool has_index(std::size_t members)
+{
+    return members > json::map_type::linear_search_limit;
+}
+
+/**
+ * Checks that every offset and size in a snapshot stays inside it, so that views never read
+ * outside the data. The slots are visited in the order dump_snapshot writes them, and each block
+ * they refer to, of elements, members, index or text, must start at or after the end of the
+ * previous one: every byte is claimed once at most, which bounds the pass and rules out cycles.
+ */
+class snapshot_validator {
+private:
+    std::string_view data_;
+    /// End of the last block claimed.
+    std::size_t claimed_{root_offset + sizeof(snapshot_slot)};
+    /// Slots still to check, the next one last; keys are flagged, as they must be strings.
+    std::vector<std::pair<std::size_t, bool>> pending_;
+    std::size_t error_offset_{};
+
+public:
+    explicit snapshot_validator(std::string_view data) : data_{data}
+    {
+    }
+
+    bool validate()
+    {
+        pending_.emplace_back(root_offset, false);
+
+        while (!pending_.empty()) {
+            const auto [at, is_key] = pending_.back();
+            pending_.pop_back();
+            if (!check_slot(at, is_key)) {
+                error_offset_ = at;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Offset of the slot that failed the check.
+    [[nodiscard]] std::size_t error_offset() const
+    {
+        return error_offset_;
+    }
+
+private:
+    /// Claims size bytes at offset at, which must follow the blocks claimed so far.
+    bool claim(std::uint64_t at, std::uint64_t size)
+    {
+        if ((at < claimed_) || (at > data_.size()) || (size > data_.size() - at))
+            return false;
+        claimed_ = static_cast<std::size_t>(at + size);
+        return true;
+    }
+
+    bool check_slot(std::size_t at, bool is_key)
+    {
+        const auto slot = read_slot(data_.data() + at);
+        const auto type = static_cast<json::class_type>(slot.type);
+
+        if (is_key && (type != json::class_type::string))
+            return false;
+
+        switch (type) {
+        case json::class_type::null:
+        case json::class_type::boolean:
+        case json::class_type::integral:
+        case json::class_type::floating:
+            return true;
+        case json::class_type::string:
+            return (slot.size <= inline_text_capacity) || claim(slot.payload, slot.size);
+        case json::class_type::array:
+            if (!claim(slot.payload, std::uint64_t{slot.size} * json_view::slot_size))
+                return false;
+            for (auto i = slot.size; i != 0; --i)
+                pending_.emplace_back(slot.payload + (i - 1) * json_view::slot_size, false);
+            return true;
+        case json::class_type::object:
+            return check_object(slot);
+        }
+        return false;
+    }
+
+    bool check_object(const snapshot_slot& slot)
+    {
+        const auto members_size = std::uint64_t{slot.size} * 2 * json_view::slot_size;
+        const auto index_size = has_index(slot.size) ? slot.size * index_entry_size : 0;
+
+        if (!claim(slot.payload, members_size + index_size))
+            return false;
+
+        // The binary search of find only follows entries that name a member.
+        const char* index = data_.data() + slot.payload + members_size;
+        for (std::size_t i = 0; i < index_size; i += index_entry_size) {
+            if (read_index(index + i) >= slot.size)
+                return false;
+        }
+
+        for (auto i = slot.size; i != 0; --i) {
+            const auto key = slot.payload + (i - 1) * 2 * json_view::slot_size;
+            pending_.emplace_back(key + json_view::slot_size, false);
+            pending_.emplace_back(key, true);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+void json::dump_snapshot(std::string& buffer) const
+{
+    const auto start = buffer.size();
+    buffer.resize(start + root_offset + sizeof(snapshot_slot));
+    serialize_snapshot(buffer, start, root_offset);
+
+    const snapshot_header header{snapshot_magic, snapshot_version, buffer.size() - start};
+    std::memcpy(buffer.data() + start, &header, sizeof(header));
+}
+
+void json::serialize_snapshot(std::string& buffer, size_type start, size_type at) const
+{
+    snapshot_slot slot{};
+    slot.type = static_cast<std::uint8_t>(internal_.value.type);
+
+    switch (internal_.value.type) {
+    case class_type::null:
+        break;
+    case class_type::boolean:
+        slot.payload = internal_.value.json_bool ? 1 : 0;
+        break;
+    case class_type::integral:
+        slot.payload = static_cast<std::uint64_t>(internal_.value.json_int);
+        break;
+    case class_type::floating:
+        std::memcpy(&slot.payload, &internal_.value.json_float, sizeof(slot.payload));
+        break;
+    case class_type::string:
+        slot = text_slot(buffer, start, string_view());
+        break;
+    case class_type::array: {
+        const auto& list = *internal_.value.json_list;
+        slot.size = checked_size(list.size());
+        slot.payload = reserve_bytes(buffer, start, list.size() * json_view::slot_size);
+
+        // Elements append what they refer to, so their slots are addressed by offset.
+        for (size_type i = 0; i < list.size(); ++i)
+            list[i].serialize_snapshot(buffer, start, slot.payload + i * json_view::slot_size);
+        break;
+    }
+    case class_type::object: {
+        const auto& map = *internal_.value.json_map;
+        const auto count = map.size();
+        const auto members_size = count * 2 * json_view::slot_size;
+
+        slot.size = checked_size(count);
+        slot.payload = reserve_bytes(
+            buffer, start, members_size + (has_index(count) ? count * index_entry_size : 0));
+
+        if (has_index(count)) {
+            std::vector<std::uint32_t> order(count);
+            for (std::uint32_t i = 0; i < count; ++i)
+                order[i] = i;
+            std::sort(order.begin(), order.end(), [&map](std::uint32_t lhs, std::uint32_t rhs) {
+                return map.begin()[lhs].first.view() < map.begin()[rhs].first.view();
+            });
+            std::memcpy(buffer.data() + start + slot.payload + members_size,
+                        order.data(),
+                        count * index_entry_size);
+        }
+
+        auto member = slot.payload;
+        for (const auto& [name, value] : map) {
+            store_slot(buffer, start, member, text_slot(buffer, start, name.view()));
+            value.serialize_snapshot(buffer, start, member + json_view::slot_size);
+            member += 2 * json_view::slot_size;
+        }
+        break;
+    }
+    }
+
+    store_slot(buffer, start, at, slot);
+}
+
+json_view json_view::at(std::string_view key) const
+{
+    const auto* slot = find(key);
+    if (slot == nullptr)
+        throw std::out_of_range{"json_view::at: no such key"};
+
+    return {base_, slot};
+}
+
+json_view json_view::at(unsigned int index) const
+{
+    size_type count{};
+    const auto* first = children(class_type::array, count);
+    if (index >= count)
+        throw std::out_of_range{"json_view::at: index out of range"};
+
+    return {base_, first + index * slot_size};
+}
+
+json_view::size_type json_view::length() const
+{
+    return (json_type() == class_type::array) ? size() : std::numeric_limits<size_type>::max();
+}
+
+bool json_view::has_key(std::string_view key) const
+{
+    return find(key) != nullptr;
+}
+
+json_view::size_type json_view::size() const
+{
+    switch (json_type()) {
+    case class_type::object:
+    case class_type::array:
+        return read_slot(slot_).size;
+    default:
+        return std::numeric_limits<size_type>::max();
+    }
+}
+
+json_view::class_type json_view::json_type() const
+{
+    return (slot_ == nullptr) ? class_type::null
+                              : static_cast<class_type>(static_cast<std::uint8_t>(*slot_));
+}
+
+bool json_view::is_null() const
+{
+    return json_type() == class_type::null;
+}
+
+std::string json_view::to_string() const
+{
+    bool b;
+    return to_string(b);
+}
+
+std::string json_view::to_string(bool& ok) const
+{
+    return (ok = json_type() == class_type::string) ? json::json_escape(string_view())
+                                                    : std::string{};
+}
+
+std::string_view json_view::string_view() const
+{
+    if (json_type() != class_type::string)
+        return {};
+
+    const auto slot = read_slot(slot_);
+    if (slot.size <= inline_text_capacity)
+        return {slot_ + offsetof(snapshot_slot, payload), slot.size};
+    return {base_ + slot.payload, slot.size};
+}
+
+json_view::float_type json_view::to_float() const
+{
+    bool b;
+    return to_float(b);
+}
+
+json_view::float_type json_view::to_float(bool& ok) const
+{
+    float_type value{};
+    if ((ok = json_type() == class_type::floating))
+        std::memcpy(&value, slot_ + offsetof(snapshot_slot, payload), sizeof(value));
+    return value;
+}
+
+json_view::int_type json_view::to_int() const
+{
+    bool b;
+    return to_int(b);
+}
+
+json_view::int_type json_view::to_int(bool& ok) const
+{
+    return (ok = json_type() == class_type::integral)
+               ? static_cast<int_type>(read_slot(slot_).payload)
+               : int_type{};
+}
+
+bool json_view::to_bool() const
+{
+    bool b;
+    return to_bool(b);
+}
+
+bool json_view::to_bool(bool& ok) const
+{
+    return (ok = json_type() == class_type::boolean) && (read_slot(slot_).payload != 0);
+}
+
+json_view::range<json_view::array_iterator> json_view::array_range() const
+{
+    size_type count{};
+    const auto* first = children(class_type::array, count);
+    return {{base_, first}, {base_, first + count * slot_size}};
+}
+
+json_view::range<json_view::object_iterator> json_view::object_range() const
+{
+    size_type count{};
+    const auto* first = children(class_type::object, count);
+    return {{base_, first}, {base_, first + count * 2 * slot_size}};
+}
+
+const char* json_view::find(std::string_view key) const
+{
+    size_type count{};
+    const auto* members = children(class_type::object, count);
+
+    auto key_of = [this, members](size_type member) {
+        return json_view{base_, members + member * 2 * slot_size}.string_view();
+    };
+
+    if (!has_index(count)) {
+        for (size_type i = 0; i < count; ++i) {
+            if (key_of(i) == key)
+                return members + i * 2 * slot_size + slot_size;
+        }
+        return nullptr;
+    }
+
+    // Binary search of the members sorted by key.
+    const auto* index = members + count * 2 * slot_size;
+    size_type first{};
+    size_type last{count};
+
+    while (first < last) {
+        const auto middle = first + (last - first) / 2;
+        const auto member = read_index(index + middle * index_entry_size);
+        const auto order = key_of(member).compare(key);
+
+        if (order == 0)
+            return members + member * 2 * slot_size + slot_size;
+        if (order < 0)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    return nullptr;
+}
+
+const char* json_view::children(class_type type, size_type& count) const
+{
+    if (json_type() != type) {
+        count = 0;
+        return nullptr;
+    }
+
+    const auto slot = read_slot(slot_);
+    count = slot.size;
+    return base_ + slot.payload;
+}
+
+json_snapshot::json_snapshot() = default;
+json_snapshot::json_snapshot(json_snapshot&& other) noexcept = default;
+json_snapshot& json_snapshot::operator=(json_snapshot&& other) noexcept = default;
+json_snapshot::~json_snapshot() = default;
+
+json_snapshot json_snapshot::load(std::string_view data)
+{
+    json_error error;
+    return load(data, error);
+}
+
+json_snapshot json_snapshot::load(std::string_view data, json_error& error)
+{
+    error = json_error{};
+    json_snapshot snapshot;
+
+    snapshot_header header{};
+    if (data.size() >= root_offset + sizeof(snapshot_slot))
+        std::memcpy(&header, data.data(), sizeof(header));
+
+    if ((header.magic != snapshot_magic) || (header.version != snapshot_version) ||
+        (header.size != data.size())) {
+        error.code = json_errc::invalid_snapshot;
+        return snapshot;
+    }
+
+    snapshot_validator validator{data};
+    if (!validator.validate()) {
+        error.code = json_errc::invalid_snapshot;
+        error.offset = validator.error_offset();
+        return snapshot;
+    }
+
+    snapshot.data_ = data;
+    return snapshot;
+}
+
+json_snapshot json_snapshot::load_file(const std::string& path)
+{
+    json_error error;
+    return load_file(path, error);
+}
+
+json_snapshot json_snapshot::load_file(const std::string& path, json_error& error)
+{
+    auto file =
+        std::make_unique<detail::mapped_file>(path, detail::mapped_file::access_hint::random);
+    if (!file->ok()) {
+        error = json_error{};
+        error.code = json_errc::io_error;
+        return json_snapshot{};
+    }
+
+    auto snapshot = load(file->view(), error);
+    if (!error)
+        snapshot.file_ = std::move(file);
+    return snapshot;
+}
+
+json_view json_snapshot::root() const
+{
+    return data_.empty() ? json_view{} : json_view{data_.data(), data_.data() + root_offset};
+}
+
+std::string_view json_snapshot::data() const
+{
+    return data_;
+}
@@ -0,0 +1,133 @@
+#include "json_stats.h"
+#include "json_stats_recorder.h"
+
+#ifdef JSONLW_ENABLE_STATS
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#endif
+
+using namespace wingmann;
+
+#ifdef JSONLW_ENABLE_STATS
+
+namespace {
+
+/// Forwards to upstream, counting what is allocated while statistics are active on the thread.
+class counting_memory_resource final : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream_;
+
+public:
+    explicit counting_memory_resource(std::pmr::memory_resource* upstream) : upstream_{upstream}
+    {
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        void* p = upstream_->allocate(bytes, alignment);
+
+        if (auto stats = detail::active_stats) {
+            ++stats->allocations;
+            stats->allocated_bytes += bytes;
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        upstream_->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return (this == &other) || upstream_->is_equal(other);
+    }
+};
+
+} // namespace
+
+std::pmr::memory_resource* detail::counting_resource(std::pmr::memory_resource* upstream)
+{
+    using wrappers_type =
+        std::unordered_map<std::pmr::memory_resource*, std::unique_ptr<counting_memory_resource>>;
+
+    // Never destroyed, so documents freed during static destruction can still reach upstream.
+    static auto wrappers = new wrappers_type;
+    static std::mutex mutex;
+
+    std::lock_guard lock{mutex};
+
+    auto& wrapper = (*wrappers)[upstream];
+    if (!wrapper)
+        wrapper = std::make_unique<counting_memory_resource>(upstream);
+    return wrapper.get();
+}
+
+#endif
+
+json json::load(std::string_view value,
+                json_error& error,
+                json_stats& stats,
+                std::pmr::memory_resource* resource)
+{
+    return std::move(load(value, parser_backend::recursive_descent, error, stats, resource));
+}
+
+json json::load(std::string_view value,
+                parser_backend backend,
+                json_error& error,
+                json_stats& stats,
+                std::pmr::memory_resource* resource)
+{
+    stats = {};
+    detail::stats_scope scope{stats};
+
+    auto result = load(value, backend, error, detail::counting_resource(resource));
+    stats.bytes = error ? error.offset : value.size();
+    return result;
+}
+
+json json::load(std::string_view value,
+                json_thread_pool& pool,
+                json_error& error,
+                json_stats& stats,
+                std::pmr::memory_resource* resource)
+{
+    stats = {};
+    detail::stats_scope scope{stats};
+
+    auto result = load(value, pool, error, detail::counting_resource(resource));
+    stats.bytes = error ? error.offset : value.size();
+    return result;
+}
+
+void json::dump(std::string& buffer,
+                json_stats& stats,
+                dump_style style,
+                std::string_view tab) const
+{
+    stats = {};
+    detail::stats_scope scope{stats};
+
+    const auto start = buffer.size();
+    json_sink sink{buffer};
+    serialize(sink, style, tab, 1);
+    stats.bytes = buffer.size() - start;
+}
+
+void json::dump(std::string& buffer,
+                json_thread_pool& pool,
+                json_stats& stats,
+                dump_style style,
+                std::string_view tab) const
+{
+    stats = {};
+    detail::stats_scope scope{stats};
+
+    const auto start = buffer.size();
+    json_sink sink{buffer};
+    serialize(sink, style, tab, 1, &pool);
+    stats.bytes = buffer.size() - start;
+}
@@ -0,0 +1,226 @@
+#ifndef WINGMANN_JSONLW_JSON_STATS_RECORDER_H
+#define WINGMANN_JSONLW_JSON_STATS_RECORDER_H
+
+#include "json_stats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory_resource>
+#ifdef JSONLW_ENABLE_STATS
+#include <mutex>
+#endif
+#include <utility>
+
+// Hooks that the parser and the serializer call to fill in json_stats. They record into the
+// statistics made active on the calling thread by stats_scope, if any, which stats_share carries
+// over to the tasks run on a thread pool. Without JSONLW_ENABLE_STATS they are empty and inline,
+// so they compile to nothing.
+
+namespace wingmann::detail {
+
+#ifdef JSONLW_ENABLE_STATS
+
+/// Statistics of the call in progress on this thread, or null.
+inline thread_local json_stats* active_stats{};
+/// Nesting of the values enclosing the ones counted on this thread.
+inline thread_local std::size_t active_depth{};
+
+/// Counts a node of type at depth below the active nesting, counting from one.
+inline void count_node(json::class_type type, std::size_t depth)
+{
+    if (auto stats = active_stats) {
+        ++stats->nodes[static_cast<std::size_t>(type)];
+        stats->max_depth = std::max(stats->max_depth, active_depth + depth);
+    }
+}
+
+/// Adds the time until it goes out of scope to one of the durations of json_stats.
+class stats_timer {
+private:
+    using clock = std::chrono::steady_clock;
+
+    json_stats::duration* total_{};
+    clock::time_point start_;
+
+public:
+    explicit stats_timer(json_stats::duration json_stats::*total)
+    {
+        if (auto stats = active_stats) {
+            total_ = &(stats->*total);
+            start_ = clock::now();
+        }
+    }
+
+    stats_timer(const stats_timer&) = delete;
+    stats_timer& operator=(const stats_timer&) = delete;
+
+    ~stats_timer()
+    {
+        if (total_ != nullptr)
+            *total_ += std::chrono::duration_cast<json_stats::duration>(clock::now() - start_);
+    }
+};
+
+/// Counts a node one level below the enclosing one, and nests what is counted until it ends.
+class stats_nesting {
+public:
+    explicit stats_nesting(json::class_type type)
+    {
+        count_node(type, 1);
+        ++active_depth;
+    }
+
+    stats_nesting(const stats_nesting&) = delete;
+    stats_nesting& operator=(const stats_nesting&) = delete;
+
+    ~stats_nesting()
+    {
+        --active_depth;
+    }
+};
+
+/// Makes stats the active statistics of this thread, and times the whole call into it.
+class stats_scope {
+private:
+    json_stats* previous_;
+    std::size_t previous_depth_;
+    stats_timer total_;
+
+public:
+    explicit stats_scope(json_stats& stats)
+        : previous_{std::exchange(active_stats, &stats)},
+          previous_depth_{std::exchange(active_depth, 0)},
+          total_{&json_stats::total_time}
+    {
+    }
+
+    stats_scope(const stats_scope&) = delete;
+    stats_scope& operator=(const stats_scope&) = delete;
+
+    ~stats_scope()
+    {
+        // The timer already holds its duration, so it still records after this.
+        active_stats = previous_;
+        active_depth = previous_depth_;
+    }
+};
+
+/**
+ * The statistics active on a thread that hands work to other threads, at the nesting it had then.
+ * Each task records into statistics of its own through stats_task_scope, which are added to
+ * these when it ends, so the threads never write to the same counters.
+ */
+class stats_share {
+private:
+    friend class stats_task_scope;
+
+    json_stats* target_{active_stats};
+    std::size_t depth_{active_depth};
+    std::mutex mutex_;
+
+public:
+    stats_share() = default;
+
+    stats_share(const stats_share&) = delete;
+    stats_share& operator=(const stats_share&) = delete;
+
+private:
+    /// Adds what a task recorded; bytes and total_time belong to the whole call.
+    void merge(const json_stats& stats)
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        for (std::size_t i = 0; i < stats.nodes.size(); ++i)
+            target_->nodes[i] += stats.nodes[i];
+        target_->max_depth = std::max(target_->max_depth, stats.max_depth);
+        target_->allocations += stats.allocations;
+        target_->allocated_bytes += stats.allocated_bytes;
+        target_->string_time += stats.string_time;
+        target_->number_time += stats.number_time;
+        target_->container_time += stats.container_time;
+    }
+};
+
+/// Records what a task of share does on this thread, and adds it to share when it ends.
+class stats_task_scope {
+private:
+    stats_share& share_;
+    json_stats stats_;
+    json_stats* previous_;
+    std::size_t previous_depth_;
+
+public:
+    explicit stats_task_scope(stats_share& share)
+        : share_{share},
+          previous_{std::exchange(active_stats, (share.target_ != nullptr) ? &stats_ : nullptr)},
+          previous_depth_{std::exchange(active_depth, share.depth_)}
+    {
+    }
+
+    stats_task_scope(const stats_task_scope&) = delete;
+    stats_task_scope& operator=(const stats_task_scope&) = delete;
+
+    ~stats_task_scope()
+    {
+        active_stats = previous_;
+        active_depth = previous_depth_;
+
+        if (share_.target_ != nullptr)
+            share_.merge(stats_);
+    }
+};
+
+/**
+ * upstream behind a wrapper that counts the allocations made while statistics are active.
+ * Nodes keep the resource they came from, so the wrapper is never destroyed.
+ */
+std::pmr::memory_resource* counting_resource(std::pmr::memory_resource* upstream);
+
+#else
+
+inline void count_node(json::class_type, std::size_t)
+{
+}
+
+class stats_timer {
+public:
+    explicit stats_timer(json_stats::duration json_stats::*)
+    {
+    }
+};
+
+class stats_nesting {
+public:
+    explicit stats_nesting(json::class_type)
+    {
+    }
+};
+
+class stats_scope {
+public:
+    explicit stats_scope(json_stats&)
+    {
+    }
+};
+
+class stats_share {
+};
+
+class stats_task_scope {
+public:
+    explicit stats_task_scope(stats_share&)
+    {
+    }
+};
+
+inline std::pmr::memory_resource* counting_resource(std::pmr::memory_resource* upstream)
+{
+    return upstream;
+}
+
+#endif
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_STATS_RECORDER_H
@@ -0,0 +1,276 @@
+#include "json_structural.h"
+#include "json_simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace wingmann::detail {
+namespace {
+
+constexpr std::size_t block_size{64};
+
+unsigned count_trailing_zeros(std::uint64_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+/**
+ * Marks the characters preceded by an odd number of backslashes.
+ * escape_carry is set when the block ends with such a backslash, so the next one starts escaped.
+ */
+std::uint64_t find_escaped(std::uint64_t backslash, std::uint64_t& escape_carry)
+{
+    constexpr std::uint64_t odd_bits{0xAAAAAAAAAAAAAAAAULL};
+
+    if (backslash == 0) {
+        auto escaped = escape_carry;
+        escape_carry = 0;
+        return escaped;
+    }
+
+    // Subtracting the run starts from their odd-shifted copies flips the bit after each run
+    // exactly when the run has odd length.
+    const auto potential_escape = backslash & ~escape_carry;
+    const auto maybe_escaped = (potential_escape << 1) | odd_bits;
+    const auto escape_and_terminal_code = (maybe_escaped - potential_escape) ^ odd_bits;
+    const auto escaped = escape_and_terminal_code ^ (backslash | escape_carry);
+
+    escape_carry = (escape_and_terminal_code & backslash) >> 63;
+    return escaped;
+}
+
+/// Bit i is the xor of bits 0 to i, which turns quote positions into a mask of string interiors.
+std::uint64_t prefix_xor(std::uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+} // namespace
+
+block_masks classify_scalar(const char* block)
+{
+    block_masks masks{};
+
+    for (std::size_t i = 0; i < block_size; ++i) {
+        const auto bit = std::uint64_t{1} << i;
+
+        switch (block[i]) {
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case '\"':
+            masks.quote |= bit;
+            break;
+        case '{':
+        case '}':
+        case '[':
+        case ']':
+        case ':':
+        case ',':
+            masks.op |= bit;
+            break;
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\v':
+        case '\f':
+        case '\r':
+            masks.space |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    return masks;
+}
+
+#ifdef WINGMANN_JSONLW_X86_SIMD
+
+namespace {
+
+WINGMANN_JSONLW_TARGET_AVX2 std::uint64_t to_mask(__m256i low, __m256i high)
+{
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(low)) |
+           (static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(high)))
+            << 32);
+}
+
+WINGMANN_JSONLW_TARGET_AVX2 __m256i match_op(__m256i chunk)
+{
+    auto hits = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('{'));
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('}')));
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('[')));
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(']')));
+    hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(':')));
+    return _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(',')));
+}
+
+WINGMANN_JSONLW_TARGET_AVX2 __m256i match_space(__m256i chunk)
+{
+    // isspace in the C locale: the space and 0x09 to 0x0D.
+    const auto shifted = _mm256_sub_epi8(chunk, _mm256_set1_epi8(0x09));
+    auto hits = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(0x04)), shifted);
+    return _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')));
+}
+
+} // namespace
+
+WINGMANN_JSONLW_TARGET_AVX2 block_masks classify_avx2(const char* block)
+{
+    const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto quote = _mm256_set1_epi8('\"');
+
+    block_masks masks;
+    masks.backslash =
+        to_mask(_mm256_cmpeq_epi8(low, backslash), _mm256_cmpeq_epi8(high, backslash));
+    masks.quote = to_mask(_mm256_cmpeq_epi8(low, quote), _mm256_cmpeq_epi8(high, quote));
+    masks.op = to_mask(match_op(low), match_op(high));
+    masks.space = to_mask(match_space(low), match_space(high));
+    return masks;
+}
+
+#endif
+
+classify_kernel default_classify_kernel()
+{
+#ifdef WINGMANN_JSONLW_X86_SIMD
+    static const classify_kernel kernel = cpu_has_avx2() ? classify_avx2 : classify_scalar;
+    return kernel;
+#else
+    return classify_scalar;
+#endif
+}
+
+namespace {
+
+/**
+ * Runs the block pipeline of stage one over [data, data + size) and calls
+ * visit(base, tokens, ops) for every block: tokens has a bit for each token start of the block,
+ * ops one for each structural character outside strings. Stops early when visit returns false.
+ */
+template<typename Visit>
+void scan_blocks(const char* data, std::size_t size, classify_kernel kernel, Visit visit)
+{
+    std::uint64_t escape_carry{};
+    std::uint64_t in_string_carry{};
+    // The start of the input counts as a delimiter, so a leading number is a token.
+    std::uint64_t delimiter_carry{1};
+    char tail[block_size];
+
+    for (std::size_t base = 0; base < size; base += block_size) {
+        const char* block = data + base;
+
+        // Pad the last block with spaces, which add no tokens.
+        if (size - base < block_size) {
+            std::memset(tail, ' ', block_size);
+            std::memcpy(tail, block, size - base);
+            block = tail;
+        }
+
+        const auto masks = kernel(block);
+        const auto quote = masks.quote & ~find_escaped(masks.backslash, escape_carry);
+
+        // Set from an opening quote up to, but not including, its closing quote.
+        const auto in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+        // A number or literal starts at any other character that follows a delimiter.
+        const auto delimiter = masks.space | masks.op | quote;
+        const auto token_start = ~delimiter & ((delimiter << 1) | delimiter_carry);
+        delimiter_carry = delimiter >> 63;
+
+        const auto ops = masks.op & ~in_string;
+        if (!visit(base, (ops | (token_start & ~in_string)) | (quote & in_string), ops))
+            return;
+    }
+}
+
+} // namespace
+
+void build_structural_index(const char* data,
+                            std::size_t size,
+                            std::vector<std::uint32_t>& index,
+                            classify_kernel kernel)
+{
+    std::size_t count{};
+
+    scan_blocks(data, size, kernel, [&](std::size_t base, std::uint64_t tokens, std::uint64_t) {
+        if (index.size() < count + block_size)
+            index.resize(std::max(index.size() * 2, count + block_size));
+
+        auto* out = index.data() + count;
+        while (tokens != 0) {
+            *out++ = static_cast<std::uint32_t>(base + count_trailing_zeros(tokens));
+            tokens &= tokens - 1;
+        }
+        count = static_cast<std::size_t>(out - index.data());
+        return true;
+    });
+
+    index.resize(count);
+}
+
+bool find_array_elements(const char* data,
+                         std::size_t size,
+                         std::size_t open,
+                         std::vector<std::size_t>& separators,
+                         classify_kernel kernel)
+{
+    std::size_t depth{};
+    bool closed{};
+
+    separators.clear();
+
+    scan_blocks(data, size, kernel, [&](std::size_t base, std::uint64_t, std::uint64_t ops) {
+        // Skip whatever precedes the opening bracket.
+        if (base + block_size <= open)
+            return true;
+        if (base <= open)
+            ops &= ~std::uint64_t{0} << (open - base);
+
+        while (ops != 0) {
+            const auto position = base + count_trailing_zeros(ops);
+            ops &= ops - 1;
+
+            switch (data[position]) {
+            case '[':
+            case '{':
+                ++depth;
+                break;
+            case ']':
+            case '}':
+                if (--depth == 0) {
+                    separators.push_back(position);
+                    closed = true;
+                    return false;
+                }
+                break;
+            case ',':
+                if (depth == 1)
+                    separators.push_back(position);
+                break;
+            default:
+                break;
+            }
+        }
+        return true;
+    });
+
+    return closed;
+}
+
+} // namespace wingmann::detail
@@ -0,0 +1,68 @@
+#ifndef WINGMANN_JSONLW_JSON_STRUCTURAL_H
+#define WINGMANN_JSONLW_JSON_STRUCTURAL_H
+
+#include "json_simd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace wingmann::detail {
+
+/// Bit i of each mask describes byte i of a 64-byte block.
+struct block_masks {
+    std::uint64_t backslash;
+    std::uint64_t quote;
+    /// Structural characters: { } [ ] : and the comma.
+    std::uint64_t op;
+    std::uint64_t space;
+};
+
+using classify_kernel = block_masks (*)(const char* block);
+
+block_masks classify_scalar(const char* block);
+#ifdef WINGMANN_JSONLW_X86_SIMD
+block_masks classify_avx2(const char* block);
+#endif
+
+/// The AVX2 kernel when the CPU supports it, the scalar one otherwise.
+classify_kernel default_classify_kernel();
+
+/// Inputs up to this size can be indexed, as positions are stored in 32 bits.
+constexpr std::size_t max_indexed_size{UINT32_MAX};
+
+/**
+ * Stage one of the structural-index parser: fills index with the position of every token
+ * of [data, data + size), in order. That is every structural character and opening quote
+ * outside strings, and the first character of every number and literal.
+ *
+ * Works on 64-byte blocks: kernel classifies the bytes into bit masks, and escaped quotes,
+ * string interiors and token starts are then derived with a few integer operations per block.
+ *
+ * A backslash escapes the next character everywhere, not only in strings. Outside strings that
+ * only happens in invalid input, which stage two rejects when it reaches the token holding the
+ * backslash; an unterminated string is likewise reported by stage two.
+ */
+void build_structural_index(const char* data,
+                            std::size_t size,
+                            std::vector<std::uint32_t>& index,
+                            classify_kernel kernel = default_classify_kernel());
+
+/**
+ * Splits the array whose opening bracket is at data[open] into its elements, using the same
+ * SIMD classification as build_structural_index so that brackets and commas in strings are
+ * skipped. separators receives the position of every comma between top-level elements, then
+ * that of the closing bracket.
+ *
+ * Only nesting depth is tracked, not the kind of bracket; mismatched brackets are left for the
+ * parser of each element to report. Returns false when the array is not closed.
+ */
+bool find_array_elements(const char* data,
+                         std::size_t size,
+                         std::size_t open,
+                         std::vector<std::size_t>& separators,
+                         classify_kernel kernel = default_classify_kernel());
+
+} // namespace wingmann::detail
+
+#endif // WINGMANN_JSONLW_JSON_STRUCTURAL_H
@@ -0,0 +1,218 @@
+#include "json_thread_pool.h"
+#include "json_stats_recorder.h"
+
+#include <algorithm>
+#include <exception>
+
+using namespace wingmann;
+
+namespace {
+
+/// Pool and queue of the worker running on this thread; null on other threads.
+thread_local const json_thread_pool* current_pool{};
+thread_local std::size_t current_queue{};
+
+/// Ranges handed out per worker, so that stealing can even out uneven ranges.
+constexpr std::size_t ranges_per_worker{8};
+
+} // namespace
+
+json_thread_pool::json_thread_pool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<task_queue>());
+
+    threads_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        threads_.emplace_back(&json_thread_pool::work, this, i);
+}
+
+json_thread_pool::~json_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock{wake_mutex_};
+        stop_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto& thread : threads_)
+        thread.join();
+}
+
+json_thread_pool::size_type json_thread_pool::size() const
+{
+    return threads_.size();
+}
+
+/// Progress of the ranges of a job, shared by its tasks.
+struct json_thread_pool::job::state {
+    range_task task;
+    std::atomic<size_type> remaining{};
+    std::mutex done_mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+    detail::stats_share stats;
+};
+
+void json_thread_pool::parallel_for(size_type count, const range_task& task, size_type grain)
+{
+    if (count == 0)
+        return;
+
+    grain = std::max({grain, size_type{1}, count / (size() * ranges_per_worker)});
+
+    if (grain >= count) {
+        task(0, count);
+        return;
+    }
+    start_for(count, task, grain).wait();
+}
+
+json_thread_pool::job json_thread_pool::start_for(size_type count, range_task task, size_type grain)
+{
+    auto state = std::make_shared<job::state>();
+    state->task = std::move(task);
+
+    if (count == 0)
+        return job{*this, std::move(state)};
+
+    grain = std::max({grain, size_type{1}, count / (size() * ranges_per_worker)});
+    state->remaining = (count + grain - 1) / grain;
+
+    for (size_type first = 0; first < count; first += grain) {
+        const size_type last = std::min(count, first + grain);
+
+        submit([state, first, last] {
+            try {
+                detail::stats_task_scope scope{state->stats};
+                state->task(first, last);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock{state->done_mutex};
+                if (!state->error)
+                    state->error = std::current_exception();
+            }
+
+            // Count down under the lock, so that the waiter cannot miss the notification.
+            std::lock_guard<std::mutex> lock{state->done_mutex};
+            if (--state->remaining == 0)
+                state->done.notify_all();
+        });
+    }
+    return job{*this, std::move(state)};
+}
+
+json_thread_pool::job::job(json_thread_pool& pool, std::shared_ptr<state> state)
+    : pool_{&pool}, state_{std::move(state)}
+{
+}
+
+json_thread_pool::job& json_thread_pool::job::operator=(job&& other) noexcept
+{
+    if (this != &other) {
+        try {
+            wait();
+        }
+        catch (...) {
+        }
+        pool_ = other.pool_;
+        state_ = std::move(other.state_);
+    }
+    return *this;
+}
+
+json_thread_pool::job::~job()
+{
+    try {
+        wait();
+    }
+    catch (...) {
+    }
+}
+
+void json_thread_pool::job::wait()
+{
+    if (!state_)
+        return;
+
+    const auto state = std::move(state_);
+
+    // Help with the queued work, then wait for the ranges other threads are still running.
+    const size_type home = (current_pool == pool_) ? current_queue : 0;
+    while ((state->remaining.load() != 0) && pool_->run_one(home)) {
+    }
+
+    std::unique_lock<std::mutex> lock{state->done_mutex};
+    state->done.wait(lock, [&] { return state->remaining.load() == 0; });
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+void json_thread_pool::submit(std::function<void()> task)
+{
+    // Workers keep what they spawn close by; other threads spread it over all queues.
+    const size_type index = (current_pool == this) ? current_queue
+                                                   : next_queue_.fetch_add(1) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock{queues_[index]->mutex};
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock{wake_mutex_};
+        ++pending_;
+    }
+    wake_.notify_one();
+}
+
+bool json_thread_pool::run_one(size_type home)
+{
+    std::function<void()> task;
+
+    for (size_type i = 0; i < queues_.size(); ++i) {
+        const size_type index = (home + i) % queues_.size();
+        auto& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+
+        if (queue.tasks.empty())
+            continue;
+
+        // The newest task of the own queue is the most likely to be in cache; steal the oldest.
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        break;
+    }
+
+    if (!task)
+        return false;
+
+    --pending_;
+    task();
+    return true;
+}
+
+void json_thread_pool::work(size_type index)
+{
+    current_pool = this;
+    current_queue = index;
+
+    while (true) {
+        if (run_one(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock{wake_mutex_};
+        wake_.wait(lock, [this] { return stop_ || (pending_.load() != 0); });
+
+        if (stop_ && (pending_.load() == 0))
+            return;
+    }
+}
@@ -0,0 +1,33 @@
+#include "test.h"
+
+#include <cstdio>
+
+namespace {
+
+int failed{};
+
+} // namespace
+
+void check(bool passed, const std::string& what, const std::string& input)
+{
+    if (!passed) {
+        std::fprintf(stderr, "FAILED: %s\n  in: %s\n", what.c_str(), input.c_str());
+        ++failed;
+    }
+}
+
+int failures()
+{
+    return failed;
+}
+
+int main()
+{
+    test_load_allocations();
+    test_parallel_load();
+    test_bind();
+    test_snapshot();
+    test_push_parser();
+    test_sink();
+    return (failures() == 0) ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#ifndef WINGMANN_JSONLW_TEST_H
+#define WINGMANN_JSONLW_TEST_H
+
+#include <string>
+
+/// Reports a failed check with the input it was made on.
+void check(bool passed, const std::string& what, const std::string& input);
+
+/// Number of checks that failed so far.
+int failures();
+
+// One function per test file, each running all of its checks.
+void test_load_allocations();
+void test_parallel_load();
+void test_bind();
+void test_snapshot();
+void test_push_parser();
+void test_sink();
+
+#endif // WINGMANN_JSONLW_TEST_H
@@ -0,0 +1,79 @@
+#include "json_bind.h"
+#include "test.h"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+struct counters {
+    std::uint64_t u{};
+    std::uint32_t small{};
+    std::optional<std::uint64_t> maybe;
+    double d{};
+};
+
+JSONLW_BIND(counters, u, small, maybe, d)
+
+void check_unsigned()
+{
+    counters value{std::numeric_limits<std::uint64_t>::max(), 7, std::uint64_t{1} << 63, 0.5};
+    const auto text = json_dump(value);
+
+    counters loaded;
+    json_error error;
+    check(json_load(text, loaded, error), "unsigned round trip: load", text);
+    check(loaded.u == value.u, "unsigned round trip: u", text);
+    check(loaded.maybe == value.maybe, "unsigned round trip: maybe", text);
+
+    // Integers beyond std::int64_t go to floating-point fields exactly as far as they can.
+    const std::string into_double{R"({"d":18446744073709551615})"};
+    check(json_load(into_double, loaded) && (loaded.d == 18446744073709551615.0),
+          "unsigned into double",
+          into_double);
+
+    // Numbers that do not fit the field are refused rather than truncated.
+    const std::string too_large{R"({"small":18446744073709551615})"};
+    check(!json_load(too_large, loaded, error) && (error.code == json_errc::type_mismatch),
+          "unsigned too large for the field",
+          too_large);
+
+    const std::string beyond{R"({"u":18446744073709551616})"};
+    check(!json_load(beyond, loaded, error) && (error.code == json_errc::type_mismatch),
+          "unsigned beyond std::uint64_t",
+          beyond);
+}
+
+void check_vector_of_bool()
+{
+    const std::string text{"[true,false,true]"};
+    std::vector<bool> flags{false};
+
+    check(json_load(text, flags) && (flags == std::vector<bool>{true, false, true}),
+          "vector<bool>: load",
+          text);
+    check(json_dump(flags) == text, "vector<bool>: dump", text);
+
+    const std::string nested{"[[true],[],[false,false]]"};
+    std::vector<std::vector<bool>> rows;
+    check(json_load(nested, rows) && (json_dump(rows) == nested), "vector<bool>: nested", nested);
+
+    const std::string mixed{"[true,1]"};
+    json_error error;
+    check(!json_load(mixed, flags, error) && (error.code == json_errc::type_mismatch),
+          "vector<bool>: element that is not a bool",
+          mixed);
+}
+
+} // namespace
+
+void test_bind()
+{
+    check_unsigned();
+    check_vector_of_bool();
+}
@@ -0,0 +1,229 @@
+#include "json.h"
+#include "json_handler.h"
+#include "test.h"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+void check_allocations(std::size_t actual, std::size_t expected, const std::string& text)
+{
+    check(actual == expected,
+          std::to_string(actual) + " allocations, expected " + std::to_string(expected),
+          text);
+}
+
+/// Counts the allocations made through it.
+class counting_resource final : public std::pmr::memory_resource {
+public:
+    std::size_t allocations{};
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * Works out the allocations a load should make from the events of the document: a container
+ * takes its holder and, unless it is empty, one buffer of its final size; an object too large to
+ * be searched linearly also takes its index; a string too long to be stored inline takes a holder
+ * and its buffer; a key too long to be stored inline takes one.
+ */
+class expected_allocations final : public json_handler {
+public:
+    std::size_t allocations{};
+
+private:
+    /// Elements or members of each open container so far, innermost last.
+    std::vector<std::size_t> sizes_;
+
+    void add_value()
+    {
+        if (!sizes_.empty() && (sizes_.back()++ == 0))
+            ++allocations;
+    }
+
+    void start_container()
+    {
+        add_value();
+        sizes_.push_back(0);
+        ++allocations;
+    }
+
+public:
+    bool on_null() override
+    {
+        add_value();
+        return true;
+    }
+
+    bool on_bool(bool) override
+    {
+        add_value();
+        return true;
+    }
+
+    bool on_number(std::int64_t) override
+    {
+        add_value();
+        return true;
+    }
+
+    bool on_number(double) override
+    {
+        add_value();
+        return true;
+    }
+
+    bool on_string(std::string_view value) override
+    {
+        add_value();
+        allocations += (value.size() > json::short_string_capacity) ? 2 : 0;
+        return true;
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        allocations += (key.size() > json_key::inline_capacity) ? 1 : 0;
+        return true;
+    }
+
+    bool on_start_object() override
+    {
+        start_container();
+        return true;
+    }
+
+    bool on_end_object() override
+    {
+        allocations += (sizes_.back() > json::map_type::linear_search_limit) ? 1 : 0;
+        sizes_.pop_back();
+        return true;
+    }
+
+    bool on_start_array() override
+    {
+        start_container();
+        return true;
+    }
+
+    bool on_end_array() override
+    {
+        sizes_.pop_back();
+        return true;
+    }
+};
+
+/// Records like a typical API response, few enough that the open values stay in the builder's
+/// inline scratch space, so every allocation belongs to a node.
+std::string records(int count)
+{
+    std::string text{"["};
+
+    for (int i = 0; i < count; ++i) {
+        if (i != 0)
+            text += ',';
+        text += R"({"id":)" + std::to_string(i) + R"(,"name":"user with a long enough name",)"
+                R"("a key too long to be stored inline":[1.5,-2,true,null],"tags":[],)"
+                R"("position":{"x":)" + std::to_string(i * 3) + R"(,"y":{}}})";
+    }
+    text += ']';
+    return text;
+}
+
+const std::vector<std::string>& documents()
+{
+    static const std::vector<std::string> all{
+        "null",
+        "\"short\"",
+        "\"a string longer than the inline capacity\"",
+        "[]",
+        "{}",
+        "[[],[[]],{}]",
+        R"({"a":1,"b":[1,2,3],"c":{"d":"e"}})",
+        R"({"a":1,"b":2,"c":3,"d":4,"e":5,"f":6,"g":7,"h":8,"i":9,"j":10})",
+        R"(["line one\nline \"two\"","tab\tand \u00e9 after it"])",
+        records(1),
+        records(12),
+    };
+    return all;
+}
+
+std::size_t expected_for(const std::string& text)
+{
+    expected_allocations expected;
+    check(json::parse(text, expected), "parse", text);
+    return expected.allocations;
+}
+
+void check_load(json::parser_backend backend)
+{
+    for (const auto& text : documents()) {
+        // Escaped strings are decoded into one buffer, kept for the whole load; the ones here are
+        // too long for its inline capacity.
+        const std::size_t decode_buffer = (text.find('\\') != std::string::npos) ? 1 : 0;
+
+        counting_resource resource;
+        json_error error;
+        {
+            auto value = json::load(text, backend, error, &resource);
+            check(!error, "load", text);
+        }
+        check_allocations(resource.allocations, expected_for(text) + decode_buffer, text);
+    }
+}
+
+void check_load_msgpack()
+{
+    for (const auto& text : documents()) {
+        std::string data;
+        json::load(text).dump_msgpack(data);
+
+        counting_resource resource;
+        {
+            auto value = json::load_msgpack(data, &resource);
+        }
+        check_allocations(resource.allocations, expected_for(text), text);
+    }
+}
+
+void check_load_cbor()
+{
+    for (const auto& text : documents()) {
+        std::string data;
+        json::load(text).dump_cbor(data);
+
+        counting_resource resource;
+        {
+            auto value = json::load_cbor(data, &resource);
+        }
+        check_allocations(resource.allocations, expected_for(text), text);
+    }
+}
+
+} // namespace
+
+void test_load_allocations()
+{
+    check_load(json::parser_backend::recursive_descent);
+    check_load(json::parser_backend::structural_index);
+    check_load_msgpack();
+    check_load_cbor();
+}
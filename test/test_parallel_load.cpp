@@ -0,0 +1,54 @@
+#include "json.h"
+#include "json_thread_pool.h"
+#include "test.h"
+
+#include <string>
+
+using namespace wingmann;
+
+namespace {
+
+/// A top-level array starting with first, padded with more elements past the parallel threshold.
+std::string padded_array(const std::string& first)
+{
+    std::string text{"[" + first};
+
+    while (text.size() < json::parallel_load_threshold)
+        text += ",1";
+    text += ']';
+    return text;
+}
+
+/// Checks that the parallel load reports what the sequential one does.
+void check_as_sequential(json_thread_pool& pool, const std::string& text, const std::string& name)
+{
+    json_error expected;
+    auto sequential = json::load(text, expected);
+
+    json_error error;
+    auto parallel = json::load(text, pool, error);
+
+    check(error.code == expected.code, name + ": error code", text.substr(0, 80));
+    check(error.offset == expected.offset, name + ": error offset", text.substr(0, 80));
+    check(parallel.length() == sequential.length(), name + ": length", text.substr(0, 80));
+}
+
+} // namespace
+
+void test_parallel_load()
+{
+    json_thread_pool pool{2};
+
+    check_as_sequential(pool, padded_array(R"({"a":[1,2,{"b":null}]})"), "valid");
+    check_as_sequential(pool, padded_array("[1,2"), "unclosed element");
+    check_as_sequential(pool, padded_array("tru"), "bad literal");
+
+    // The elements are nested in the array, so one nested max_depth deep more is too deep.
+    const auto depth = json::max_depth;
+    check_as_sequential(pool,
+                        padded_array(std::string(depth, '[') + std::string(depth, ']')),
+                        "too deep");
+    check_as_sequential(pool,
+                        padded_array(std::string(depth - 1, '[') + std::string(depth - 1, ']')),
+                        "deepest");
+}
@@ -0,0 +1,136 @@
+#include "json.h"
+#include "json_builder.h"
+#include "json_handler.h"
+#include "json_push_parser.h"
+#include "test.h"
+
+#include <string>
+#include <vector>
+
+using namespace wingmann;
+
+namespace {
+
+/// Writes down every event, so that two parses can be compared.
+class event_log final : public json_handler {
+public:
+    std::string events;
+
+    bool on_null() override
+    {
+        events += "null ";
+        return true;
+    }
+
+    bool on_bool(bool value) override
+    {
+        events += value ? "true " : "false ";
+        return true;
+    }
+
+    bool on_number(std::int64_t value) override
+    {
+        events += "int:" + std::to_string(value) + ' ';
+        return true;
+    }
+
+    bool on_number(double value) override
+    {
+        events += "float:" + std::to_string(value) + ' ';
+        return true;
+    }
+
+    bool on_string(std::string_view value) override
+    {
+        events += "string:" + std::string{value} + ' ';
+        return true;
+    }
+
+    bool on_key(std::string_view key) override
+    {
+        events += "key:" + std::string{key} + ' ';
+        return true;
+    }
+
+    bool on_start_object() override
+    {
+        events += "{ ";
+        return true;
+    }
+
+    bool on_end_object() override
+    {
+        events += "} ";
+        return true;
+    }
+
+    bool on_start_array() override
+    {
+        events += "[ ";
+        return true;
+    }
+
+    bool on_end_array() override
+    {
+        events += "] ";
+        return true;
+    }
+};
+
+/**
+ * Feeds the start of an abandoned document, cut inside an escape, a number or a literal, then
+ * resets the parser and feeds a whole one: only the events of the second may be reported.
+ */
+void check_reset()
+{
+    const std::vector<std::string> abandoned{
+        R"(["\ud83d)", R"(["\u00)", R"({"key\)", R"([12.5e)", R"([tr)", R"({"a":[{"b":)"};
+    const std::string text{R"({"s":"xéy","n":[-1.5,20],"t":true})"};
+
+    event_log expected;
+    json::parse(text, expected);
+
+    for (const auto& start : abandoned) {
+        event_log log;
+        json_push_parser parser{log};
+
+        parser.feed(start);
+        parser.reset();
+        log.events.clear();
+
+        check(parser.feed(text) && parser.finish(), "reset: second document", start);
+        check(log.events == expected.events, "reset: events of the second document", start);
+        check(!parser.error(), "reset: error", start);
+    }
+}
+
+/// Feeds one byte at a time, so that every token is split, and compares with json::load.
+void check_byte_by_byte()
+{
+    const std::vector<std::string> documents{
+        R"({"s":"tab\tquote\" é 😀","n":[0,-12,3.25e-2,1E3],"l":[true,false,null]})",
+        R"(["\ud83d no low half", "a", {"nested":{"deeper":[[]]}}])",
+        "  -0.5  ",
+    };
+
+    for (const auto& text : documents) {
+        json_builder builder;
+        json_push_parser parser{builder};
+
+        bool ok{true};
+        for (char c : text)
+            ok = ok && parser.feed(&c, 1);
+        ok = ok && parser.finish();
+
+        check(ok, "byte by byte: parse", text);
+        check(builder.result().dump() == json::load(text).dump(), "byte by byte: value", text);
+    }
+}
+
+} // namespace
+
+void test_push_parser()
+{
+    check_reset();
+    check_byte_by_byte();
+}
@@ -0,0 +1,126 @@
+#include "json.h"
+#include "json_sink.h"
+#include "test.h"
+
+#include <string>
+
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace wingmann;
+
+#ifdef __linux__
+
+namespace {
+
+/// Descriptor that takes no bytes, with every ::write to it returning zero; -1 for none.
+int refusing_fd{-1};
+/// Writes attempted on it; after max_refused_writes they fail, so that a sink stuck retrying
+/// still returns and the test can report it.
+int refused_writes{};
+constexpr int max_refused_writes{1000};
+
+} // namespace
+
+// Stands in for the C library's write, which the sink in the library calls, so that it can be
+// handed a descriptor that accepts no bytes; other descriptors are written as usual.
+extern "C" ssize_t write(int fd, const void* data, size_t size)
+{
+    if ((fd != refusing_fd) || (size == 0))
+        return syscall(SYS_write, fd, data, size);
+
+    if (++refused_writes > max_refused_writes) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+namespace {
+
+json sample()
+{
+    return json::load(R"({"a":[1,2,3],"b":"a string longer than the inline capacity"})");
+}
+
+void check_refusing_descriptor()
+{
+    int fds[2]{};
+    check(pipe(fds) == 0, "pipe", "pipe()");
+
+    refusing_fd = fds[1];
+    refused_writes = 0;
+    {
+        json_sink sink{fds[1], 16};
+        sample().dump(sink);
+        sink.flush();
+
+        check(!sink.good(), "descriptor that accepts no bytes: good", sample().dump());
+    }
+    check(refused_writes == 1,
+          "descriptor that accepts no bytes: " + std::to_string(refused_writes) + " writes",
+          sample().dump());
+
+    refusing_fd = -1;
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void check_full_device()
+{
+    const int fd = open("/dev/full", O_WRONLY);
+    if (fd < 0)
+        return;
+    {
+        json_sink sink{fd, 16};
+        sample().dump(sink);
+        sink.flush();
+
+        check(!sink.good(), "/dev/full: good", sample().dump());
+    }
+    close(fd);
+}
+
+void check_pipe()
+{
+    int fds[2]{};
+    check(pipe(fds) == 0, "pipe", "pipe()");
+
+    const auto value = sample();
+    {
+        json_sink sink{fds[1], 16};
+        value.dump(sink);
+        sink.flush();
+        check(sink.good(), "pipe: good", value.dump());
+    }
+    close(fds[1]);
+
+    std::string text;
+    char buffer[256];
+    for (ssize_t n; (n = read(fds[0], buffer, sizeof(buffer))) > 0;)
+        text.append(buffer, static_cast<std::size_t>(n));
+    close(fds[0]);
+
+    check(text == value.dump(), "pipe: text", text);
+}
+
+} // namespace
+
+void test_sink()
+{
+    check_pipe();
+    check_full_device();
+    check_refusing_descriptor();
+}
+
+#else
+
+void test_sink()
+{
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "json.h"
+#include "json_view.h"
+#include "test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace wingmann;
+
+namespace {
+
+/// Offset of the size field in the snapshot header, which must match the length of the data.
+constexpr std::size_t header_size_offset{8};
+/// Offset of the payload of the root slot, which follows the header.
+constexpr std::size_t root_payload_offset{24};
+
+/// A document with every kind of slot: inline and out-of-line strings, nested containers, and an
+/// object large enough to carry an index.
+std::string sample_text()
+{
+    std::string text{R"({"name":"a string too long to be stored inline",)"
+                     R"("list":[1,-2.5,true,null,[]],"nested":{"x":{"y":["z"]}},"wide":{)"};
+    for (int i = 0; i < 20; ++i)
+        text += ((i != 0) ? ",\"key" : "\"key") + std::to_string(i) + "\":" + std::to_string(i);
+    text += "}}";
+    return text;
+}
+
+std::string sample_snapshot()
+{
+    std::string snapshot;
+    json::load(sample_text()).dump_snapshot(snapshot);
+    return snapshot;
+}
+
+/// Builds the json that view describes, reading every slot reachable from it.
+json to_json(json_view view)
+{
+    switch (view.json_type()) {
+    case json::class_type::object: {
+        auto object = json::object();
+        for (auto [key, value] : view.object_range())
+            object[key] = to_json(value);
+        return object;
+    }
+    case json::class_type::array: {
+        auto array = json::array();
+        for (auto element : view.array_range())
+            array.append(to_json(element));
+        return array;
+    }
+    case json::class_type::string:
+        return json{std::string{view.string_view()}};
+    case json::class_type::floating:
+        return json{view.to_float()};
+    case json::class_type::integral:
+        return json{view.to_int()};
+    case json::class_type::boolean:
+        return json{view.to_bool()};
+    default:
+        return json{nullptr};
+    }
+}
+
+void store_u64(std::string& data, std::size_t at, std::uint64_t value)
+{
+    std::memcpy(data.data() + at, &value, sizeof(value));
+}
+
+/// Opens data, which must either be rejected as invalid_snapshot or be walkable as a whole.
+bool opens(const std::string& data, const std::string& what)
+{
+    json_error error;
+    auto snapshot = json_snapshot::load(data, error);
+
+    if (error) {
+        check(error.code == json_errc::invalid_snapshot, "error code", what);
+        return false;
+    }
+    std::string text;
+    to_json(snapshot.root()).dump(text);
+    return true;
+}
+
+void check_valid()
+{
+    const auto data = sample_snapshot();
+    const auto text = sample_text();
+
+    json_error error;
+    auto snapshot = json_snapshot::load(data, error);
+    check(!error, "valid snapshot: load", text);
+
+    // Keys of the wide object are found through its index, and the walk gives back the document.
+    check(snapshot.root().at("wide").at("key17").to_int() == 17, "valid snapshot: index", text);
+    check(to_json(snapshot.root()).dump() == json::load(text).dump(), "valid snapshot: walk", text);
+}
+
+void check_truncated()
+{
+    const auto data = sample_snapshot();
+
+    for (std::size_t size = 0; size < data.size(); ++size) {
+        auto truncated = data.substr(0, size);
+        const auto what = "snapshot truncated to " + std::to_string(size) + " bytes";
+        check(!opens(truncated, what), "accepted", what);
+
+        // With the size in the header fixed up, only the offsets and sizes of the slots give it
+        // away.
+        if (truncated.size() >= root_payload_offset + sizeof(std::uint64_t)) {
+            store_u64(truncated, header_size_offset, truncated.size());
+            check(!opens(truncated, what + ", header fixed"), "accepted", what + ", header fixed");
+        }
+    }
+}
+
+void check_bad_offsets()
+{
+    const auto data = sample_snapshot();
+
+    // The root object pointing past the end, or just before its own slot.
+    for (std::uint64_t offset : {std::uint64_t{data.size()}, ~std::uint64_t{}, std::uint64_t{8}}) {
+        auto corrupted = data;
+        store_u64(corrupted, root_payload_offset, offset);
+        const auto what = "root offset " + std::to_string(offset);
+        check(!opens(corrupted, what), "accepted", what);
+    }
+
+    // Every eight-byte word of the slots overwritten in turn: whatever is accepted must be
+    // readable without leaving the snapshot.
+    const std::uint64_t values[]{0, data.size(), ~std::uint64_t{}};
+
+    for (std::size_t at = root_payload_offset - 8; at + 8 <= data.size(); at += 8) {
+        for (auto value : values) {
+            auto corrupted = data;
+            store_u64(corrupted, at, value);
+            opens(corrupted, "corrupted word at " + std::to_string(at));
+        }
+    }
+}
+
+} // namespace
+
+void test_snapshot()
+{
+    check_valid();
+    check_truncated();
+    check_bad_offsets();
+}